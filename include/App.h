@@ -6,6 +6,7 @@
 #include <Windows.h>
 #include "TradingUI.h"
 #include "CryptoAPIClient.h" // Add CryptoAPIClient include
+#include "MarketFeed.h"
 
 // Forward declare the window procedure
 LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
@@ -42,6 +43,9 @@ private:
     // API client
     std::shared_ptr<CryptoAPIClient> m_apiClient;
 
+    // Push price feed, if one is configured
+    std::shared_ptr<MarketFeed> m_marketFeed;
+
     // Data update timer
     float m_lastUpdateTime = 0.0f;
 
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// OHLCV bars for one symbol, oldest first, stored column by column. The symbol is held
+// once for the whole series and each field is contiguous, so a series can be filled by
+// the API client and plotted without reshuffling or copying.
+class BarSeries {
+public:
+    BarSeries() = default;
+    explicit BarSeries(std::string symbol)
+        : m_symbol(std::move(symbol)) {
+    }
+
+    const std::string& GetSymbol() const { return m_symbol; }
+    void SetSymbol(std::string symbol) { m_symbol = std::move(symbol); }
+
+    size_t Size() const { return m_timestamps.size(); }
+    bool Empty() const { return m_timestamps.empty(); }
+
+    void Reserve(size_t count) {
+        m_timestamps.reserve(count);
+        m_opens.reserve(count);
+        m_highs.reserve(count);
+        m_lows.reserve(count);
+        m_closes.reserve(count);
+        m_volumes.reserve(count);
+    }
+
+    // Remove every bar, keeping the symbol and the allocated columns
+    void Clear() {
+        m_timestamps.clear();
+        m_opens.clear();
+        m_highs.clear();
+        m_lows.clear();
+        m_closes.clear();
+        m_volumes.clear();
+    }
+
+    // Add a bar after the last one; timestamp is the bar's start in seconds since the epoch
+    void Append(int64_t timestamp, double open, double high, double low, double close, double volume) {
+        m_timestamps.push_back(timestamp);
+        m_opens.push_back(open);
+        m_highs.push_back(high);
+        m_lows.push_back(low);
+        m_closes.push_back(close);
+        m_volumes.push_back(volume);
+    }
+
+    // Columns, all Size() long
+    const std::vector<int64_t>& GetTimestamps() const { return m_timestamps; }
+    const std::vector<double>& GetOpens() const { return m_opens; }
+    const std::vector<double>& GetHighs() const { return m_highs; }
+    const std::vector<double>& GetLows() const { return m_lows; }
+    const std::vector<double>& GetCloses() const { return m_closes; }
+    const std::vector<double>& GetVolumes() const { return m_volumes; }
+
+private:
+    std::string m_symbol;
+    std::vector<int64_t> m_timestamps;
+    std::vector<double> m_opens;
+    std::vector<double> m_highs;
+    std::vector<double> m_lows;
+    std::vector<double> m_closes;
+    std::vector<double> m_volumes;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Persistent store of settled OHLCV bars, one append-only binary file per symbol
+// and interval (<directory>/<SYMBOL>_<interval>.bars). Each file is a small header
+// followed by fixed-size records in native byte order; a later record for the same
+// timestamp replaces an earlier one. Files are compacted when they accumulate
+// duplicates or bars older than the window being loaded, or end in a torn record.
+class BarStore {
+public:
+    struct Bar {
+        int64_t timestamp = 0;      // start of the bar (seconds since the epoch, UTC)
+        bool unavailable = false;   // the symbol had no data for this bar
+        double open = 0.0;
+        double high = 0.0;
+        double low = 0.0;
+        double close = 0.0;
+        double volume = 0.0;
+    };
+
+    explicit BarStore(std::string directory);
+
+    // Load the stored bars at or after keepFrom, oldest first. Returns false if there
+    // is no usable file
+    bool Load(const std::string& symbol, const std::string& interval, int64_t keepFrom, std::vector<Bar>& bars);
+
+    // Append settled bars, creating the file if needed
+    bool Append(const std::string& symbol, const std::string& interval, const std::vector<Bar>& bars);
+
+private:
+    std::string GetPath(const std::string& symbol, const std::string& interval) const;
+
+    // Replace the file with just these bars (mutex held)
+    bool Rewrite(const std::string& path, const std::vector<Bar>& bars);
+
+    std::string m_directory;
+
+    // Serializes file access across the request workers
+    std::mutex m_mutex;
+};
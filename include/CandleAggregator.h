@@ -0,0 +1,88 @@
+#pragma once
+
+#include "BarSeries.h"
+#include "ColumnarBarFile.h"
+#include "InstrumentRegistry.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bar lengths kept for every symbol
+enum class CandleInterval {
+    OneMinute,
+    FiveMinutes,
+    FifteenMinutes,
+    OneHour,
+    OneDay
+};
+
+const size_t CANDLE_INTERVAL_COUNT = 5;
+
+// Builds candles for every interval at once from a stream of price ticks.
+// Each tick updates the open candle of each interval (or starts the next one) in
+// constant time, so the chart can switch interval without refetching. Candles are
+// stored column by column and handed out as views, for drawing in place. Not
+// thread-safe: the chart feeds it ticks on the render thread, which reads the candles
+// too, so drawing never waits on the feed.
+class CandleAggregator {
+public:
+    // capacity: candles kept at least per symbol and interval. Up to twice as many are
+    // held, and the oldest dropped in one go, so the columns stay contiguous and most
+    // changes leave every candle but the newest as it was
+    explicit CandleAggregator(size_t capacity);
+
+    static int64_t GetIntervalSeconds(CandleInterval interval);
+    static const char* GetIntervalLabel(CandleInterval interval);
+
+    // Fold a tick into every interval. volume is the quantity traded with the tick
+    // (zero when the source only reports prices). Ticks older than an interval's
+    // open candle are ignored for that interval
+    void AddTick(InstrumentId instrument, double timestamp, double price, double volume = 0.0);
+
+    // Replace an interval's candles with history, keeping any candle built from ticks
+    // since the last one of it
+    void Seed(InstrumentId instrument, CandleInterval interval, const BarSeries& history);
+
+    // An interval's candles, oldest first, the open one last (timestamps are the start of
+    // each interval, in seconds since the epoch). Valid until the candles next change
+    OhlcvColumns GetCandles(InstrumentId instrument, CandleInterval interval) const;
+
+    // Changes whenever any of the instrument's candles do
+    uint64_t GetVersion(InstrumentId instrument) const;
+
+    // Changes whenever the instrument's candles change other than by updating the newest
+    // one or appending more: while it holds, a later view of an interval repeats an
+    // earlier one's candles but its last, so only those from there on need redrawing
+    uint64_t GetLayout(InstrumentId instrument) const;
+
+private:
+    // One interval's candles
+    struct CandleColumns {
+        std::vector<double> timestamps;
+        std::vector<double> opens;
+        std::vector<double> highs;
+        std::vector<double> lows;
+        std::vector<double> closes;
+        std::vector<double> volumes;
+
+        size_t Size() const { return timestamps.size(); }
+        void Append(double timestamp, double open, double high, double low, double close, double volume);
+
+        // Drop all but the newest count candles
+        void KeepNewest(size_t count);
+    };
+
+    struct SymbolCandles {
+        std::array<CandleColumns, CANDLE_INTERVAL_COUNT> series;
+        uint64_t version = 0;
+        uint64_t layout = 0;
+    };
+
+    // The instrument's candles, created on first use
+    SymbolCandles& GetInstrument(InstrumentId instrument);
+
+    // Indexed by instrument id; instruments never ticked have no candles
+    std::vector<SymbolCandles> m_instruments;
+    size_t m_capacity;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "imgui.h"
+#include "CandleGeometry.h"
+#include <cstddef>
+
+// Candlesticks built by CandleGeometry, emitted into a draw list as two batches, every
+// wick and then every body, reserving vertices up front instead of adding one
+// primitive per call
+class CandleBatch : public CandleGeometry {
+public:
+    void Draw(ImDrawList* drawList, ImU32 bullColor, ImU32 bearColor) const;
+
+private:
+    // Rectangles per reservation; four vertices each keeps the count within 16-bit indices
+    static const size_t RECTS_PER_RESERVE = 8192;
+};
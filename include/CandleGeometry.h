@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ColumnarBarFile.h"
+#include <cstddef>
+#include <vector>
+
+// Linear mapping from plot coordinates to pixels: pixel = origin + value * scale
+struct PlotTransform {
+    double originX = 0.0;
+    double scaleX = 1.0;
+    double originY = 0.0;
+    double scaleY = 1.0;
+};
+
+// Candlestick geometry for many bars at once, in pixel space. Build() maps a range of
+// bars in one pass over the columns, with one transform for the whole range instead of
+// a coordinate conversion per point. The buffers are kept between builds.
+class CandleGeometry {
+public:
+    // Map bars [first, last) to pixels; candleWidth is the body width in plot units
+    void Build(const OhlcvColumns& columns, size_t first, size_t last, double candleWidth,
+        const PlotTransform& transform);
+
+    // The same over a series in two parts, one pass over each
+    void Build(const OhlcvSpans& bars, size_t first, size_t last, double candleWidth,
+        const PlotTransform& transform);
+
+    size_t Size() const { return m_x.size(); }
+
+protected:
+    // Pixel columns, one entry per bar
+    std::vector<float> m_x;
+    std::vector<float> m_open;
+    std::vector<float> m_close;
+    std::vector<float> m_high;
+    std::vector<float> m_low;
+    float m_halfWidth = 0.5f;
+
+private:
+    void Resize(size_t count);
+
+    // Map bars [first, last) of columns to the pixel columns from index at on
+    void Map(const OhlcvColumns& columns, size_t first, size_t last, size_t at, const PlotTransform& transform);
+
+    void SetWidth(double candleWidth, const PlotTransform& transform);
+};
@@ -2,13 +2,18 @@
 
 #include "imgui.h"
 #include "ChartRenderer.h"
+#include "CandleAggregator.h"
+#include "ColumnarBarFile.h"
+#include "HandoffQueue.h"
+#include "MpscQueue.h"
+#include "CryptoAPIClient.h"
+#include "MarketState.h"
+#include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <vector>
 
-class CryptoAPIClient;
-struct PriceData;
-
 class ChartPanel {
 public:
     ChartPanel();
@@ -19,25 +24,102 @@ public:
 
     // API integration
     void SetAPIClient(std::shared_ptr<CryptoAPIClient> apiClient);
-    void UpdateChartData(const std::string& symbol);
+    void UpdateChartData(const std::string& symbol, bool fetchQuote = true,
+        RequestPriority priority = RequestPriority::Interactive);
+
+    // Show an instrument's latest quote (ignored if it is not the charted one)
+    void ApplyQuote(InstrumentId instrument, const MarketQuote& quote);
+
+    // Where quotes fetched by the chart are sent; they are shown once they come back
+    // through ApplyQuote. Called on the request workers
+    void SetQuoteCallback(CryptoAPIClient::QuoteCallback callback) { m_quoteCallback = std::move(callback); }
+
+    // Queue a price update for the symbol's candles (safe from any thread); it is folded
+    // in on the render thread at the next frame
+    void AddTick(const PriceData& priceData);
 
     // Getters/Setters
     void SetSymbol(const std::string& symbol);
     const std::string& GetSymbol() const { return m_symbol; }
+    InstrumentId GetInstrument() const { return m_instrument; }
     float GetCurrentPrice() const { return m_displayedPrice; }
 
 private:
     // UI elements
     void RenderSymbolSelector();
+    void RenderIntervalSelector();
     void AnimatePrice();
 
+    // Partial or final historical series handed over from the request workers
+    struct HistoricalUpdate {
+        InstrumentId instrument = INVALID_INSTRUMENT;
+        std::shared_ptr<const BarSeries> series;
+        bool isComplete = false;
+    };
+
+    // A price update on its way from the feed to the candles
+    struct CandleTick {
+        InstrumentId instrument = INVALID_INSTRUMENT;
+        double timestamp = 0.0;
+        double price = 0.0;
+    };
+
+    // Fold the ticks queued since the last frame into the candles (render thread)
+    void DrainTicks();
+
+    // Apply pending historical updates (called once per frame on the render thread)
+    void DrainHistoricalUpdates();
+    void ApplyHistoricalData(InstrumentId instrument, const BarSeries& historicalData);
+
+    // Hand the selected interval's candles to the renderer if they changed since last shown
+    void RefreshChart();
+
+    // Map the symbol's saved minute history, unless the file already mapped is unchanged.
+    // Returns true if the mapping was replaced
+    bool OpenMappedHistory(const std::string& symbol);
+
+    // Add the symbol's closed minute candles to its saved minute history
+    void SaveMinuteHistory(const std::string& symbol);
+
     // Chart state
     ChartRenderer m_chartRenderer;
     std::string m_symbol = "ETH";
+    InstrumentId m_instrument = INVALID_INSTRUMENT;     // m_symbol's id, compared on every quote
     bool m_isLoading = false;
     std::string m_errorMessage;
     bool m_usingRealData = false;
 
+    // Candles for every interval, built from history and live ticks. Only the render thread
+    // touches them; ticks reach it through a lock-free queue, so the feed never blocks a frame
+    CandleAggregator m_candles;
+    MpscQueue<CandleTick> m_ticks;
+    CandleInterval m_interval = CandleInterval::OneDay;
+
+    // The candles last handed to the renderer: their version and layout, and how many
+    uint64_t m_shownVersion = 0;
+    uint64_t m_shownLayout = 0;
+    size_t m_shownCount = 0;
+
+    // Set when the chart shows a different symbol, interval or source, so the next refresh
+    // refits the view; other updates keep the user's zoom
+    bool m_chartDirty = true;
+
+    // Set while a newly shown symbol's history is loading, so each part of it is shown in full
+    bool m_fitHistory = true;
+
+    // Long minute-bar history saved in columnar form, plotted in place at the 1m interval
+    // (the renderer holds views of it, so it is cleared there before the mapping goes). The
+    // file's size and write time are kept so it is only remapped after it changes
+    std::shared_ptr<const ColumnarBarFile> m_mappedHistory;
+    std::string m_mappedHistoryPath;
+    std::filesystem::file_time_type m_mappedHistoryTime;
+    uintmax_t m_mappedHistorySize = 0;
+    bool m_mappedHistoryChanged = false;
+
+    // Historical data arriving from the request workers
+    HandoffQueue<HistoricalUpdate> m_historicalUpdates;
+    std::vector<HistoricalUpdate> m_drainedUpdates;
+
     // Price animation state
     float m_displayedPrice = 2500.0f;
     float m_targetPrice = 2500.0f;
@@ -49,6 +131,7 @@ private:
 
     // API client
     std::shared_ptr<CryptoAPIClient> m_apiClient;
+    CryptoAPIClient::QuoteCallback m_quoteCallback;
 
     // Font reference
     ImFont* m_boldFont = nullptr;
@@ -2,8 +2,12 @@
 
 #include "imgui.h"
 #include "implot.h"
+#include "ColumnarBarFile.h"
+#include "CandleBatch.h"
+#include "OhlcPyramid.h"
 #include <vector>
 #include <string>
+#include <memory>
 
 // Define chart display modes
 enum class ChartDisplayMode {
@@ -34,13 +38,16 @@ public:
             ChartDisplayMode::Line : ChartDisplayMode::Candlestick;
     }
 
-    // Set the chart data (new method for API integration)
-    void SetChartData(const std::vector<double>& timestamps,
-        const std::vector<double>& opens,
-        const std::vector<double>& highs,
-        const std::vector<double>& lows,
-        const std::vector<double>& closes,
-        const std::vector<double>& volumes);
+    // Plot bars in place, e.g. candles, or a memory-mapped history followed by the live
+    // candles after it; the caller keeps them valid until the next SetChartData or
+    // ClearChartData. Bars before firstChanged must be those of the last call, so only the
+    // rest are merged into the pyramid again. resetView refits the time axis to the whole
+    // series; otherwise the zoom is kept
+    void SetChartData(const OhlcvSpans& bars, size_t firstChanged, bool resetView = true);
+
+    // Forget the bars last given (e.g. before their file is replaced). Nothing is plotted
+    // until the next SetChartData
+    void ClearChartData();
 
     // Set the cryptocurrency symbol for the chart title
     void SetSymbol(const std::string& symbol) { m_symbol = symbol; }
@@ -53,9 +60,20 @@ private:
     void RenderCandlestickChart();
     void RenderLineChart();
 
-    // Helper function to draw a single candlestick
-    void DrawCandlestick(double x, double open, double close, double low, double high,
-        const ImVec4& bullColor, const ImVec4& bearColor, double width);
+    // Mapping from the current plot's coordinates to pixels (inside BeginPlot/EndPlot)
+    static PlotTransform GetPlotTransform();
+
+    // The pyramid level that puts at least pixelsPerBucket pixels between buckets at
+    // the current zoom, and the range [first, last) of its buckets in view (inside
+    // BeginPlot/EndPlot)
+    OhlcPyramid::Level SelectLevel(float pixelsPerBucket, size_t& first, size_t& last);
+
+    // Bars [first, last) between two times, with one bar of margin either side
+    void FindBars(double minTime, double maxTime, size_t& first, size_t& last) const;
+
+    // Axis limits (inside BeginPlot): the time axis is refitted to the whole data when it
+    // was replaced, and the price axis fits the lows and highs (or the closes) in view
+    void SetupAxisLimits(bool fitCloses);
 
     // Data handling
     void UpdateData();
@@ -72,11 +90,34 @@ private:
     // Current cryptocurrency symbol
     std::string m_symbol = "ETH";
 
-    // Sample data
-    std::vector<double> m_sampleTimestamps;
-    std::vector<double> m_sampleOpens;
-    std::vector<double> m_sampleHighs;
-    std::vector<double> m_sampleLows;
-    std::vector<double> m_sampleCloses;
-    std::vector<double> m_sampleVolumes;
+    // Bars being plotted, owned by whoever passed them to SetChartData
+    OhlcvSpans m_bars;
+
+    // Bars shown until the first SetChartData
+    struct SampleBars {
+        std::vector<double> timestamps;
+        std::vector<double> opens;
+        std::vector<double> highs;
+        std::vector<double> lows;
+        std::vector<double> closes;
+        std::vector<double> volumes;
+    };
+    SampleBars m_sampleBars;
+
+    // Set when new data should be shown in full; cleared once the time axis is refitted
+    bool m_resetView = true;
+
+    // Time range shown last frame; the price axis is set up before this frame's is known
+    double m_viewMinTime = 0.0;
+    double m_viewMaxTime = 0.0;
+
+    // Merged levels of the columns, updated from the first changed bar when the data is
+    // set. They double as the price extents of any range of bars
+    OhlcPyramid m_pyramid;
+
+    // Candle geometry and the line chart's points (the close envelope, or closes gathered
+    // from both parts of the bars), rebuilt each frame into the same buffers
+    CandleBatch m_candleBatch;
+    std::vector<double> m_envelopeTimes;
+    std::vector<double> m_envelopeCloses;
 };
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+
+// Circuit breaker for one API endpoint.
+// Closed: requests flow. After enough consecutive failures it opens and requests
+// fail fast; once the open period has passed it goes half-open and lets a single
+// probe through. A successful probe closes it again, a failed one re-opens it for
+// twice as long (up to a limit). Not thread-safe; the owner serialises access.
+class CircuitBreaker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class State {
+        Closed,
+        Open,
+        HalfOpen
+    };
+
+    enum class Admission {
+        Allow,      // send the request
+        Reject,     // fail it now
+        Wait        // the server asked for a pause; try again after retryAfter
+    };
+
+    CircuitBreaker(int failureThreshold = 5,
+        Clock::duration openDuration = std::chrono::seconds(30),
+        Clock::duration maxOpenDuration = std::chrono::minutes(5));
+
+    // Decide whether a request may go out now. In half-open state the first
+    // caller gets the probe and must report its outcome (or ReleaseProbe())
+    Admission Admit(Clock::time_point now, Clock::duration& retryAfter);
+
+    // Give back a probe that was admitted but never sent
+    void ReleaseProbe();
+
+    void RecordSuccess();
+    void RecordFailure(Clock::time_point now);
+
+    // Hold requests until the time the server gave in Retry-After
+    void PauseUntil(Clock::time_point until);
+
+    State GetState() const { return m_state; }
+
+private:
+    int m_failureThreshold;
+    Clock::duration m_baseOpenDuration;
+    Clock::duration m_maxOpenDuration;
+
+    State m_state = State::Closed;
+    int m_consecutiveFailures = 0;
+    Clock::duration m_openDuration;
+    Clock::time_point m_openUntil;
+    Clock::time_point m_pausedUntil;
+    bool m_probeInFlight = false;
+};
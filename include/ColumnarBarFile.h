@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Columns of an OHLCV series, oldest bar first. A view only; the data lives elsewhere
+struct OhlcvColumns {
+    const double* timestamps = nullptr;
+    const double* opens = nullptr;
+    const double* highs = nullptr;
+    const double* lows = nullptr;
+    const double* closes = nullptr;
+    const double* volumes = nullptr;
+    size_t count = 0;
+
+    // The bars from first on
+    OhlcvColumns From(size_t first) const {
+        first = first < count ? first : count;
+        if (first == 0) {
+            return *this;
+        }
+        return { timestamps + first, opens + first, highs + first, lows + first, closes + first,
+            volumes + first, count - first };
+    }
+};
+
+// A series held in two parts, such as a mapped history and the live bars after it. Bar i
+// is the head's while i < head.count, and the tail's from there on
+struct OhlcvSpans {
+    OhlcvColumns head;
+    OhlcvColumns tail;
+
+    size_t Count() const { return head.count + tail.count; }
+
+    double TimestampAt(size_t i) const {
+        return i < head.count ? head.timestamps[i] : tail.timestamps[i - head.count];
+    }
+
+    // Call fn(part, from, to) for the bars [first, last) in each part that holds some,
+    // head first; from and to index that part
+    template <typename Fn>
+    void ForEachPart(size_t first, size_t last, Fn&& fn) const {
+        if (first < last && first < head.count) {
+            fn(head, first, last < head.count ? last : head.count);
+        }
+        if (first < last && last > head.count) {
+            fn(tail, first > head.count ? first - head.count : 0, last - head.count);
+        }
+    }
+};
+
+// Read-only, memory-mapped OHLCV history stored column by column:
+//   header | timestamps | opens | highs | lows | closes | volumes
+// Each column is count little-endian doubles. Pages are brought in by the OS as they
+// are touched, so years of minute bars cost address space rather than memory.
+class ColumnarBarFile {
+public:
+    ~ColumnarBarFile();
+
+    ColumnarBarFile(const ColumnarBarFile&) = delete;
+    ColumnarBarFile& operator=(const ColumnarBarFile&) = delete;
+
+    // Map a file; returns null if it is missing or malformed
+    static std::shared_ptr<const ColumnarBarFile> Open(const std::string& path);
+
+    // Write a series in this format, replacing path through a temporary file. Windows
+    // refuses to replace a file that is mapped, so every mapping of the old file must be
+    // released first; elsewhere a mapping left open keeps showing the old data
+    static bool Write(const std::string& path, const OhlcvColumns& columns);
+
+    // Location of a symbol's file for an interval (e.g. "1m") within directory
+    static std::string GetPath(const std::string& directory, const std::string& symbol, const std::string& interval);
+
+    // The mapped columns, valid for the lifetime of this object
+    const OhlcvColumns& GetColumns() const { return m_columns; }
+
+private:
+    ColumnarBarFile() = default;
+
+    bool Map(const std::string& path);
+    void Unmap();
+
+    OhlcvColumns m_columns;
+
+    const unsigned char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
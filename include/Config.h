@@ -9,8 +9,19 @@ namespace Config {
         // Your CoinMarketCap API key (replace with your actual key in production)
         extern std::string CMC_API_KEY;
 
-        // Base URLs for different API endpoints
-        extern const std::string CMC_BASE_URL;
+        // Base URLs for different API endpoints (can be pointed at a local stand-in from config)
+        extern std::string CMC_BASE_URL;
+
+        // Directory holding the bars saved between runs
+        extern std::string BAR_STORE_DIRECTORY;
+
+        // WebSocket price feed (empty to rely on REST polling alone)
+        extern std::string FEED_URL;
+
+        // Feed connection: silence before it is considered dead, and the longest wait
+        // between reconnection attempts (in seconds)
+        extern const int FEED_TIMEOUT_SECONDS;
+        extern const int FEED_RECONNECT_MAX_SECONDS;
 
         // API request timeouts (in seconds)
         extern const int REQUEST_TIMEOUT;
@@ -18,6 +29,40 @@ namespace Config {
         // API update intervals (in seconds)
         extern const float PRICE_UPDATE_INTERVAL;
         extern const float CHART_UPDATE_INTERVAL;
+
+        // Number of past days fetched for the historical chart
+        extern const int HISTORICAL_DAYS;
+
+        // Maximum number of requests kept in flight to any one endpoint
+        extern int MAX_CONCURRENT_REQUESTS;
+
+        // Number of worker threads issuing API requests
+        extern int WORKER_THREADS;
+
+        // API plan limits: request rate, and call credits per minute and per UTC day
+        extern int REQUESTS_PER_MINUTE;
+        extern int CREDITS_PER_MINUTE;
+        extern int CREDITS_PER_DAY;
+
+        // Fraction of each budget that background refreshes leave for user-initiated requests
+        extern const float BACKGROUND_BUDGET_RESERVE;
+
+        // Circuit breaker: consecutive server failures before an endpoint is suspended, and
+        // how long it stays suspended (doubling after each failed probe, up to the maximum)
+        extern const int CIRCUIT_FAILURE_THRESHOLD;
+        extern const int CIRCUIT_OPEN_SECONDS;
+        extern const int CIRCUIT_MAX_OPEN_SECONDS;
+
+        // Response cache: how long quotes and historical snapshots stay fresh (in seconds),
+        // and the memory it may use (in megabytes). A chart load alone keeps HISTORICAL_DAYS + 1
+        // listings responses of up to ~5 MB each, so the limit leaves room for that and more
+        extern const int QUOTE_CACHE_TTL;
+        extern const int HISTORICAL_CACHE_TTL;
+        extern const int RESPONSE_CACHE_MAX_MB;
+
+        // HTTP connection pool: maximum open connections and idle eviction time (in seconds)
+        extern const int MAX_HTTP_CONNECTIONS;
+        extern const int HTTP_IDLE_TIMEOUT;
     }
 
     // UI Settings
@@ -31,6 +76,9 @@ namespace Config {
         // Available cryptocurrencies
         extern const std::string AVAILABLE_CRYPTOS[];
         extern const int AVAILABLE_CRYPTOS_COUNT;
+
+        // Candles kept per symbol for each chart interval (a day of minute bars)
+        extern const int CANDLE_CAPACITY;
     }
 
     // Application settings
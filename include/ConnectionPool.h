@@ -0,0 +1,130 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+// Pool of keep-alive connections shared by the HTTP transports.
+// Caps the total number of open connections, hands idle ones back out per key
+// (host and port) and closes connections that have sat idle too long.
+template <typename Key, typename Handle>
+class ConnectionPool {
+public:
+    using Closer = std::function<void(Handle)>;
+
+    ConnectionPool(size_t maxConnections, int idleTimeoutSeconds, Closer closer)
+        : m_maxConnections(maxConnections > 0 ? maxConnections : 1),
+          m_idleTimeout(idleTimeoutSeconds),
+          m_closer(std::move(closer)) {
+    }
+
+    ~ConnectionPool() {
+        CloseAll();
+    }
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Take an idle connection for key. Returns true and fills handle if one was
+    // reused; returns false once a slot is reserved for the caller to open a new
+    // connection, which must then be passed to Release() (or the slot to Abandon())
+    bool Acquire(const Key& key, Handle& handle) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true) {
+            EvictIdle();
+
+            // Reuse the most recently used idle connection for this key
+            for (auto it = m_idle.rbegin(); it != m_idle.rend(); ++it) {
+                if (it->key == key) {
+                    handle = it->handle;
+                    m_idle.erase(std::next(it).base());
+                    m_active++;
+                    return true;
+                }
+            }
+
+            // At the limit, make room by closing the oldest idle connection to another key
+            if (m_active + m_idle.size() >= m_maxConnections && !m_idle.empty()) {
+                m_closer(m_idle.front().handle);
+                m_idle.erase(m_idle.begin());
+            }
+
+            if (m_active + m_idle.size() < m_maxConnections) {
+                m_active++;
+                return false;
+            }
+
+            // Every connection is busy; wait for one to come back
+            m_condition.wait(lock);
+        }
+    }
+
+    // Return a connection after use; connections that failed mid-request are closed
+    void Release(const Key& key, Handle handle, bool reusable) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_active--;
+
+            if (reusable) {
+                m_idle.push_back({ key, handle, std::chrono::steady_clock::now() });
+            }
+            else {
+                m_closer(handle);
+            }
+        }
+
+        m_condition.notify_one();
+    }
+
+    // Give back a slot reserved by Acquire() when opening the connection failed
+    void Abandon() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_active--;
+        }
+
+        m_condition.notify_one();
+    }
+
+    void CloseAll() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& connection : m_idle) {
+            m_closer(connection.handle);
+        }
+        m_idle.clear();
+    }
+
+private:
+    // An idle connection waiting to be reused
+    struct IdleConnection {
+        Key key;
+        Handle handle;
+        std::chrono::steady_clock::time_point lastUsed;
+    };
+
+    // Close connections idle past the timeout (mutex must be held)
+    void EvictIdle() {
+        auto cutoff = std::chrono::steady_clock::now() - m_idleTimeout;
+
+        // Idle connections are kept in release order, so expired ones are at the front
+        auto it = m_idle.begin();
+        while (it != m_idle.end() && it->lastUsed < cutoff) {
+            m_closer(it->handle);
+            ++it;
+        }
+        m_idle.erase(m_idle.begin(), it);
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<IdleConnection> m_idle;
+    size_t m_active = 0;
+    size_t m_maxConnections;
+    std::chrono::seconds m_idleTimeout;
+    Closer m_closer;
+};
@@ -1,18 +1,35 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
+#include <deque>
+#include <unordered_map>
+#include <array>
+#include <set>
+#include <ctime>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include "HttpTransport.h"
+#include "MpscQueue.h"
+#include "RateLimiter.h"
+#include "CircuitBreaker.h"
+#include "ResponseBufferPool.h"
+#include "ResponseCache.h"
+#include "BarStore.h"
+#include "BarSeries.h"
+#include "InstrumentRegistry.h"
 
 // Structure to store price data from the API
 struct PriceData {
     std::string symbol;
+    InstrumentId instrument = INVALID_INSTRUMENT;   // the symbol's interned id
     double price = 0.0;
     double volume24h = 0.0;
     double percentChange1h = 0.0;
@@ -30,6 +47,33 @@ struct PriceData {
     double timestamp = 0.0;
 };
 
+// Scheduling class of a request; higher classes are always dequeued first
+enum class RequestPriority {
+    Interactive,    // user-initiated, e.g. switching the charted symbol
+    Normal,
+    Background      // periodic refreshes
+};
+
+// Request counters and remaining API budget, for display
+struct APIMetrics {
+    double requestsAvailable = 0.0;     // requests that may be sent right now
+    double creditsAvailable = 0.0;      // credits left in the per-minute budget
+    double creditsUsedToday = 0.0;
+    double creditsRemainingToday = 0.0;
+
+    uint64_t requestsSent = 0;
+    uint64_t requestsDeferred = 0;      // held back by the rate limiter at least once
+    uint64_t requestsRejected = 0;      // failed because the daily credits were spent
+    uint64_t requestsRetried = 0;
+    uint64_t requestsShortCircuited = 0;    // failed fast while an endpoint's circuit was open
+    int openCircuits = 0;                   // endpoints currently open or half-open
+
+    uint64_t cacheHits = 0;             // answered from the response cache
+    uint64_t cacheMisses = 0;
+    uint64_t cacheRevalidated = 0;      // cached responses confirmed current by a 304
+    size_t cacheBytes = 0;
+};
+
 // Class for handling API communication with CoinMarketCap
 class CryptoAPIClient {
 public:
@@ -42,51 +86,285 @@ public:
     // Shutdown the API client
     void Shutdown();
 
+    // Replace the HTTP transport (e.g. with one pointed at a local stand-in); call before Initialize
+    void SetTransport(std::unique_ptr<IHttpTransport> transport) { m_transport = std::move(transport); }
+
+    // Called once per symbol with its quote; isRealData is false for mock fallbacks
+    using QuoteCallback = std::function<void(const PriceData&, bool isRealData)>;
+
     // Fetch latest quote for a cryptocurrency
-    bool FetchLatestQuote(const std::string& symbol, std::function<void(const PriceData&, bool isRealData)> callback);
+    bool FetchLatestQuote(const std::string& symbol, QuoteCallback callback,
+        RequestPriority priority = RequestPriority::Normal);
 
-    // Fetch historical data for a cryptocurrency (for charts)
-    bool FetchHistoricalData(const std::string& symbol, std::function<void(const std::vector<PriceData>&)> callback);
+    // Fetch latest quotes for several cryptocurrencies in a single request
+    bool FetchLatestQuotes(const std::vector<std::string>& symbols, QuoteCallback callback,
+        RequestPriority priority = RequestPriority::Normal);
 
-    // Get the error message
-    const std::string& GetLastError() const { return m_lastError; }
+    // Called with the series loaded so far (oldest to newest); isComplete is set on the final call.
+    // The series is shared between every caller and never changes once handed out
+    using HistoricalCallback = std::function<void(const std::shared_ptr<const BarSeries>& series, bool isComplete)>;
+
+    // Fetch historical data for a cryptocurrency (for charts). The load runs on the
+    // request workers and the callback is invoked from there, once per arriving day
+    bool FetchHistoricalData(const std::string& symbol, HistoricalCallback callback,
+        RequestPriority priority = RequestPriority::Normal);
+
+    // Cancel every queued or running single-symbol request for symbol (chart history and
+    // quotes); their callbacks are dropped. Returns the number of requests cancelled
+    size_t CancelRequestsFor(InstrumentId instrument);
+
+    // Current request counters and remaining budget (safe to call from any thread)
+    APIMetrics GetMetrics() const;
+
+    // Get the error message (safe to call while requests are in flight)
+    std::string GetLastError() const;
 
 private:
+    // Steps requests through the dispatcher by hand (tests/CryptoAPIClientTest.cpp)
+    friend class CryptoAPIClientTest;
+
     // API key
     std::string m_apiKey;
 
     // Base URL for API requests 
     std::string m_baseUrl;
 
-    // Last error message
+    // HTTP transport shared by every worker
+    std::unique_ptr<IHttpTransport> m_transport;
+
+    // Last error message, written from the workers
     std::string m_lastError;
+    mutable std::mutex m_errorMutex;
+
+    // Record an error message
+    void SetError(const std::string& error);
+
+    // Response bodies, reused per endpoint across requests
+    ResponseBufferPool m_responseBuffers;
+
+    // Recent response bodies with their TTLs and validators
+    mutable ResponseCache m_responseCache;
+
+    // How an HTTP exchange went, for the retry policy and circuit breakers
+    struct RequestOutcome {
+        bool responded = false;         // an HTTP response arrived (of any status)
+        int statusCode = 0;
+        int retryAfterSeconds = -1;     // from a Retry-After header, if any
+        bool fromCache = false;         // answered from the cache without contacting the server
+        ResponseCache::Body cachedBody; // set when the body is the cached one (a hit or a 304)
+    };
+
+    // Helper method to make an API request; the body is read into a pooled buffer, or
+    // comes from the response cache
+    bool MakeRequest(const std::string& endpoint, const std::map<std::string, std::string>& params,
+        const std::string& cacheKey, ResponseBufferPool::Buffer& response, RequestOutcome& outcome);
+
+    // State shared by the requests of one historical load
+    struct HistoricalLoad {
+        std::string symbol;
+        time_t today = 0;
+        HistoricalCallback callback;
+
+        // Bars merged so far keyed by timestamp, and requests still outstanding
+        std::mutex mutex;
+        std::map<time_t, BarStore::Bar> merged;
+        size_t remaining = 0;
+
+        // The merged bars oldest to newest (mutex held)
+        std::shared_ptr<const BarSeries> Snapshot() const {
+            auto series = std::make_shared<BarSeries>(symbol);
+            series->Reserve(merged.size());
+            for (const auto& entry : merged) {
+                const BarStore::Bar& bar = entry.second;
+                series->Append(bar.timestamp, bar.open, bar.high, bar.low, bar.close, bar.volume);
+            }
+            return series;
+        }
+    };
+
+    // Fold one day's response (empty on failure) into the load, reporting progress and
+    // completion through its callback
+    void OnHistoricalResult(HistoricalLoad& load, double timestamp, const std::string& label,
+        std::string_view response);
+
+    // Outcome of looking for one symbol in a response
+    enum class ParseResult {
+        Found,
+        Missing,
+        Error
+    };
+
+    // Extract one symbol's daily bar from a listings or quotes response
+    ParseResult ParseSymbolEntry(std::string_view response, const std::string& symbol,
+        double timestamp, PriceData& data);
+
+    // Per-symbol historical cache; days before today are settled and never refetched
+    struct SymbolHistory {
+        std::map<time_t, BarStore::Bar> settledDays;
+        std::set<time_t> unavailableDays;
+        bool restored = false;      // the bar store has been read for this symbol
+    };
+
+    std::map<std::string, SymbolHistory> m_historyCache;
+    std::mutex m_historyMutex;
 
-    // Helper method to make an API request
-    bool MakeRequest(const std::string& endpoint, const std::map<std::string, std::string>& params, std::string& response);
+    // Settled days persisted across runs, so the chart starts from disk and only the
+    // missing days are fetched
+    std::unique_ptr<BarStore> m_barStore;
+
+    // Fill in a symbol's history from the bar store the first time it is loaded
+    void RestoreHistory(const std::string& symbol, time_t windowStart);
 
     // Generate mock price data as fallback
     PriceData GenerateMockPriceData(const std::string& symbol);
 
-    // Thread for handling API requests in the background
+    // Dispatcher thread, which drains the request queues into the worker pool
     std::unique_ptr<std::thread> m_requestThread;
+    std::vector<std::thread> m_workers;
+    std::atomic<bool> m_threadRunning{ false };
+    std::mutex m_threadMutex;
 
-    // Flag to indicate if the thread should stop
+    // Flag to indicate if the threads should stop
     std::atomic<bool> m_shouldStop;
 
-    // Queue of API requests
+    // Receives a view of the pooled response body, valid only during the call
+    using ResponseCallback = std::function<void(std::string_view)>;
+
+    // Queued API request; move-only so it is never copied on its way through the queue
     struct APIRequest {
+        APIRequest() = default;
+        APIRequest(APIRequest&&) = default;
+        APIRequest& operator=(APIRequest&&) = default;
+        APIRequest(const APIRequest&) = delete;
+        APIRequest& operator=(const APIRequest&) = delete;
+
+        RequestPriority priority = RequestPriority::Normal;
         std::string endpoint;
         std::map<std::string, std::string> params;
-        std::function<void(const std::string&)> callback;
+
+        // Key into m_inFlight, and the flag set if the request is cancelled while queued
+        std::string key;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+
+        // Private callback, called exactly once (with an empty view on failure or cancellation)
+        ResponseCallback callback;
+
+        // Estimated API credits, and rate limiter state while waiting to run
+        double credits = 1.0;
+        bool deferred = false;
+        bool overBudget = false;
+
+        // Set once the circuit breaker and rate limiter let the request out, and probe if it
+        // is a half-open breaker's one trial request; a request that then goes unsent hands
+        // both back (ReturnAdmission)
+        bool admitted = false;
+        bool probe = false;
+
+        // Retry state: attempts so far and the end of the current backoff
+        int attempt = 0;
+        RateLimiter::Clock::time_point notBefore;
+        bool circuitOpen = false;
+
+        // Response cache key, and whether a fresh cached response will answer the request
+        std::string cacheKey;
+        bool fromCache = false;
+
+        // Background work run on a worker instead of a single HTTP request
+        std::function<void()> task;
     };
 
-    std::vector<APIRequest> m_requestQueue;
-    std::mutex m_queueMutex;
-    std::condition_variable m_queueCondition;
+    // One lock-free queue per priority class, fed by any thread and drained by the dispatcher
+    static constexpr size_t PRIORITY_COUNT = 3;
+    std::array<MpscQueue<APIRequest>, PRIORITY_COUNT> m_requestQueues;
+
+    // The dispatcher sleeps here only when every queue is empty
+    std::atomic<bool> m_consumerWaiting{ false };
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+
+    // Requests handed to the workers, by priority, and the number running per endpoint
+    std::array<std::deque<APIRequest>, PRIORITY_COUNT> m_readyRequests;
+    std::unordered_map<std::string, int> m_activeRequests;
+    int m_endpointLimit = 1;
+    std::mutex m_readyMutex;
+    std::condition_variable m_readyCondition;
 
-    // Thread function for processing requests
+    // Dispatcher thread function: moves queued requests to the workers
     void ProcessRequests();
 
+    // Worker thread function: runs ready requests within the per-endpoint caps
+    void WorkerLoop();
+
+    // Take the next request a worker may run (m_readyMutex held). If requests are held
+    // back by the rate limiter, retryAfter is lowered to when the next may be granted
+    bool TakeRunnable(APIRequest& request, RateLimiter::Clock::duration& retryAfter);
+
+    // Request rate and credit budget; created with the dispatcher from the loaded config
+    std::unique_ptr<RateLimiter> m_rateLimiter;
+    std::atomic<uint64_t> m_requestsSent{ 0 };
+    std::atomic<uint64_t> m_requestsDeferred{ 0 };
+    std::atomic<uint64_t> m_requestsRejected{ 0 };
+    std::atomic<uint64_t> m_requestsRetried{ 0 };
+    std::atomic<uint64_t> m_requestsShortCircuited{ 0 };
+
+    // Run one request on the calling worker and deliver its response. Returns true
+    // if it failed and should be queued again once request.notBefore has passed
+    bool ExecuteRequest(APIRequest& request);
+
+    // Per-endpoint circuit breakers
+    std::unordered_map<std::string, CircuitBreaker> m_breakers;
+    mutable std::mutex m_breakerMutex;
+
+    // The breaker for an endpoint, created on first use (m_breakerMutex held)
+    CircuitBreaker& GetBreaker(const std::string& endpoint);
+
+    // Start the dispatcher and workers if they are not running
+    void StartRequestThread();
+
+    // Pop the highest-priority pending request (dispatcher only)
+    bool PopRequest(APIRequest& request);
+
+    // True if any queue has a request (dispatcher only)
+    bool RequestsPending() const;
+
+    // Add a request to the queue and wake the dispatcher
+    void EnqueueRequest(APIRequest request);
+
+    // Callers waiting on one queued or running request
+    struct InFlightRequest {
+        InstrumentId instrument = INVALID_INSTRUMENT;   // set when the request serves a single symbol, for cancellation
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        std::vector<ResponseCallback> callbacks;
+        std::vector<HistoricalCallback> historyCallbacks;
+    };
+
+    // Requests that are queued or running, keyed by endpoint and parameters
+    std::unordered_map<std::string, InFlightRequest> m_inFlight;
+    std::mutex m_inFlightMutex;
+
+    // Build the dedup key for a request
+    static std::string MakeRequestKey(const std::string& endpoint, const std::map<std::string, std::string>& params);
+
+    // Attach the callback to the request with this key. Returns true if there was none and the
+    // caller must enqueue request (whose key and cancel flag are filled in), false if it was coalesced
+    bool RegisterRequest(APIRequest& request, const std::string& key, InstrumentId instrument,
+        ResponseCallback callback, HistoricalCallback historyCallback);
+
+    // Remove a finished request from m_inFlight and return its callbacks (none if it was cancelled)
+    std::vector<ResponseCallback> TakeCallbacks(const APIRequest& request);
+
+    // Deliver an empty response to a request that will never run, and to everyone attached to it
+    void FailRequest(APIRequest& request);
+
+    // Give back the breaker probe and rate-limit budget of an admitted request that never
+    // reached the server (answered from the cache, or cancelled before it was sent)
+    void ReturnAdmission(APIRequest& request);
+
+    // Queue the requests for the days of the historical series not already cached; progress
+    // and completion are reported through callback as they arrive
+    void LoadHistoricalData(const std::string& symbol, HistoricalCallback callback,
+        const std::shared_ptr<std::atomic<bool>>& cancelled, RequestPriority priority);
+
     // Generate mock historical data for demonstration
-    void GenerateMockHistoricalData(const std::string& symbol, std::vector<PriceData>& data, int numDays = 100);
+    void GenerateMockHistoricalData(const std::string& symbol, BarSeries& series, int numDays = 100);
 };
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <iostream>
+#endif
+
+// Write a message to the debugger output (stderr on platforms without one)
+inline void DebugLog(const std::string& message) {
+#ifdef _WIN32
+    OutputDebugStringA(message.c_str());
+#else
+    std::cerr << message;
+#endif
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Thread-safe handoff from background threads to the render thread.
+// Producers call Push() from any thread; the render thread calls Drain() once per frame.
+template <typename T>
+class HandoffQueue {
+public:
+    void Push(T item) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_items.push_back(std::move(item));
+    }
+
+    // Move all pending items into out (previous contents of out are discarded)
+    void Drain(std::vector<T>& out) {
+        out.clear();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        out.swap(m_items);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<T> m_items;
+};
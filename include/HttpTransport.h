@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+
+// Result of a single HTTP exchange
+struct HttpResponse {
+    int statusCode = 0;
+
+    // Header fields, names lower-cased
+    std::map<std::string, std::string> headers;
+
+    // Transports clear and fill this in place, so a buffer passed in keeps its capacity
+    std::string body;
+};
+
+// Interface for the HTTP layer used by CryptoAPIClient, so the backend can be
+// swapped (e.g. for a local plain-HTTP stand-in) without touching the client
+class IHttpTransport {
+public:
+    virtual ~IHttpTransport() = default;
+
+    // Make a GET request to a URL with custom headers. Returns false only if no
+    // response was received; HTTP error statuses are reported in response.statusCode
+    virtual bool Get(
+        const std::string& url,
+        const std::map<std::string, std::string>& headers,
+        HttpResponse& response,
+        std::string& error
+    ) = 0;
+};
+
+// Create the platform's default transport (WinHTTP on Windows, epoll sockets elsewhere)
+std::unique_ptr<IHttpTransport> CreateHttpTransport(size_t maxConnections, int idleTimeoutSeconds,
+    int requestTimeoutSeconds);
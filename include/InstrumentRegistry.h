@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// Dense integer handle for a ticker symbol, assigned in order of first use
+using InstrumentId = uint32_t;
+const InstrumentId INVALID_INSTRUMENT = std::numeric_limits<InstrumentId>::max();
+
+// Process-wide mapping between ticker symbols and InstrumentIds. Symbols are interned
+// where they enter the program (quote parsing, the feed, the UI's symbol lists), after
+// which price updates and lookups compare ids and index flat arrays instead of hashing
+// and comparing strings. Ids are never reused. Safe to call from any thread.
+class InstrumentRegistry {
+public:
+    static InstrumentRegistry& Instance();
+
+    // The symbol's id, assigning the next one if it has none yet
+    InstrumentId Intern(const std::string& symbol);
+
+    // The symbol's id, or INVALID_INSTRUMENT if it was never interned
+    InstrumentId Find(const std::string& symbol) const;
+
+    // The symbol for an id (empty if unknown); the reference stays valid for the life of the program
+    const std::string& GetSymbol(InstrumentId id) const;
+
+    // Number of ids assigned; every id is below this
+    size_t Size() const;
+
+private:
+    InstrumentRegistry() = default;
+
+    std::unordered_map<std::string, InstrumentId> m_ids;
+    std::deque<std::string> m_symbols;      // indexed by id; a deque keeps references stable
+    mutable std::shared_mutex m_mutex;
+};
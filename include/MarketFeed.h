@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CryptoAPIClient.h"
+#include "WebSocketTransport.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Feed connection state and counters, for display
+struct MarketFeedStats {
+    bool live = false;          // connected and hearing from the server
+    uint64_t ticks = 0;
+    uint64_t gaps = 0;          // sequence gaps, each answered with a resubscription
+    uint64_t reconnects = 0;
+};
+
+// Push-based price feed over a WebSocket. Runs on its own thread, reconnecting with
+// backoff and resubscribing whenever the connection drops.
+//
+// Protocol (JSON text messages):
+//   client: {"op":"subscribe","symbols":["BTC","ETH"]}   replaces the subscription; the
+//           server answers with a tick per symbol as a snapshot
+//   server: {"type":"tick","seq":N,"symbol":"BTC","price":...,"volume_24h":...,
+//            "percent_change_24h":...,"timestamp":...}
+//           {"type":"heartbeat","seq":N}
+// seq rises by one per message on a connection; a jump means messages were lost, and
+// the feed resubscribes to get fresh snapshots.
+class MarketFeed {
+public:
+    // Called on the feed thread for every tick
+    using TickCallback = std::function<void(const PriceData& data)>;
+
+    explicit MarketFeed(std::string url);
+    ~MarketFeed();
+
+    MarketFeed(const MarketFeed&) = delete;
+    MarketFeed& operator=(const MarketFeed&) = delete;
+
+    // Start the feed thread
+    void Start(TickCallback callback);
+
+    // Stop the feed thread; no callbacks are made once this returns
+    void Stop();
+
+    // Symbols to subscribe to; sent the next time the feed hears from the server
+    void SetSymbols(const std::vector<std::string>& symbols);
+
+    // True while connected and messages are arriving, so polling can be skipped
+    bool IsLive() const { return m_live; }
+
+    MarketFeedStats GetStats() const;
+
+private:
+    void Run();
+
+    // Read messages until the connection ends or the feed is stopped
+    void RunConnection(IWebSocketConnection& connection);
+
+    // Send the current symbol list
+    bool Subscribe(IWebSocketConnection& connection, std::string& error);
+
+    // Handle one server message; returns false if a sequence gap calls for resubscribing
+    bool HandleMessage(const std::string& message, uint64_t& lastSequence);
+
+    std::string m_url;
+    TickCallback m_callback;
+
+    std::vector<std::string> m_symbols;
+    bool m_symbolsChanged = false;
+    std::mutex m_symbolsMutex;
+
+    // The open connection, so Stop() can unblock its receive
+    IWebSocketConnection* m_connection = nullptr;
+    std::mutex m_connectionMutex;
+
+    std::unique_ptr<std::thread> m_thread;
+    std::atomic<bool> m_shouldStop{ false };
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCondition;
+
+    std::atomic<bool> m_live{ false };
+    std::atomic<uint64_t> m_ticks{ 0 };
+    std::atomic<uint64_t> m_gaps{ 0 };
+    std::atomic<uint64_t> m_reconnects{ 0 };
+};
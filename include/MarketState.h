@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CryptoAPIClient.h"
+#include "InstrumentRegistry.h"
+#include "TripleBuffer.h"
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Latest quote of one instrument
+struct MarketQuote {
+    double price = 0.0;
+    double percentChange24h = 0.0;
+    double volume24h = 0.0;
+    bool isRealData = false;
+    uint64_t sequence = 0;      // MarketSnapshot::version when it arrived; 0 if none has
+};
+
+// Consistent view of the latest quotes
+struct MarketSnapshot {
+    std::vector<MarketQuote> quotes;    // indexed by instrument id
+    uint64_t version = 0;               // rises with every quote published
+};
+
+// Latest quotes published by the network threads (request workers and the feed) for
+// the render thread. Publishers are serialized among themselves; the render thread
+// reads the newest snapshot through a triple buffer and never takes a lock or waits
+// on a publisher.
+class MarketState {
+public:
+    // Record a quote (any thread)
+    void Publish(const PriceData& data, bool isRealData);
+
+    // Newest snapshot (render thread only); valid until the next call
+    const MarketSnapshot& Acquire() { return m_snapshots.Acquire(); }
+
+private:
+    // Every quote so far, copied into the write buffer on each publish (publish mutex held)
+    MarketSnapshot m_current;
+    std::mutex m_publishMutex;
+
+    TripleBuffer<MarketSnapshot> m_snapshots;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+// Unbounded lock-free multi-producer single-consumer queue (Vyukov's intrusive design).
+// Push() may be called from any thread; TryPop() and Empty() only from the one consumer.
+// Items are moved in and out, so T only needs to be move-constructible.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue()
+        : m_head(&m_stub), m_tail(&m_stub) {
+    }
+
+    ~MpscQueue() {
+        T item;
+        while (TryPop(item)) {
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void Push(T item) {
+        Node* node = new Node(std::move(item));
+        Link(node);
+    }
+
+    // Pop the oldest item into item; returns false if the queue is empty. May also
+    // return false while a producer is between its two steps of Push()
+    bool TryPop(T& item) {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+
+        // Step past the stub node
+        if (tail == &m_stub) {
+            if (!next) {
+                return false;
+            }
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            m_tail = next;
+            item = std::move(tail->value);
+            delete tail;
+            return true;
+        }
+
+        // tail is the last node; only take it once the stub is queued behind it
+        if (tail != m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        Link(&m_stub);
+
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            m_tail = next;
+            item = std::move(tail->value);
+            delete tail;
+            return true;
+        }
+        return false;
+    }
+
+    // True if there is nothing to pop (consumer only)
+    bool Empty() const {
+        const Node* tail = m_tail;
+        return tail == &m_stub && !tail->next.load(std::memory_order_seq_cst);
+    }
+
+private:
+    struct Node {
+        Node() = default;
+        explicit Node(T&& item) : value(std::move(item)) {}
+
+        std::atomic<Node*> next{ nullptr };
+        T value;
+    };
+
+    void Link(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_seq_cst);
+    }
+
+    // Producers append at the head; the consumer removes from the tail
+    std::atomic<Node*> m_head;
+    Node* m_tail;
+    Node m_stub;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ColumnarBarFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Multi-resolution summary of an OHLCV series for drawing it zoomed out. Level 0 is the
+// series itself, never copied, and may be in two parts (a mapped history and the live
+// bars after it); level 1 merges runs of BASE_BARS_PER_BUCKET bars and
+// each level above merges pairs of the one below. A bucket keeps the first open and
+// timestamp, the highest high, the lowest low and the last close, plus the lowest and
+// highest close (and which came first) for line charts. Drawing from the level with
+// about one bucket per pixel keeps the cost in line with the plot's width rather than
+// the series' length.
+//
+// The merged levels cost about 57 bytes per bucket, so about 14 bytes per bar of the
+// series in all. Merging pairs of bars from level 0 would build four times as many
+// buckets; level 0 is instead drawn with up to BASE_BARS_PER_BUCKET bars per bucket.
+class OhlcPyramid {
+public:
+    static const size_t BASE_BARS_PER_BUCKET = 8;
+
+    // One merged level, a view into the pyramid. Volumes are not merged, so
+    // columns.volumes is not set. Level 0 has barsPerBucket 1 and no columns; its bars
+    // are those of GetBase()
+    struct Level {
+        OhlcvColumns columns;
+        const double* closeMins = nullptr;  // range of closes per bucket
+        const double* closeMaxs = nullptr;
+        const uint8_t* closeMinFirst = nullptr;     // set where the lowest close came before the highest
+        size_t barsPerBucket = 1;
+    };
+
+    // Build every merged level; the bars must stay valid while the pyramid is used
+    void Build(const OhlcvSpans& bars);
+
+    // Follow a change to the series: bars before firstChanged are those it was last built
+    // or updated with (the columns may have moved), so only the buckets holding the rest
+    // are merged again. A tick that updates the newest bar or appends one costs a bucket
+    // per level
+    void Update(const OhlcvSpans& bars, size_t firstChanged);
+
+    void Clear();
+
+    const OhlcvSpans& GetBase() const { return m_base; }
+
+    size_t GetLevelCount() const { return m_base.Count() == 0 ? 0 : m_levels.size() + 1; }
+
+    Level GetLevel(size_t level) const;
+
+    // The finest level at which visibleBars bars make at most maxBuckets buckets, or
+    // level 0 if they are at most BASE_BARS_PER_BUCKET times as many
+    Level SelectLevel(double visibleBars, double maxBuckets) const;
+
+    // Lowest low and highest high of bars [first, last). The levels are used as a segment
+    // tree, so this takes O(log N) however wide the range; false if it is empty
+    bool GetPriceRange(size_t first, size_t last, double& low, double& high) const;
+
+    // The same over the closes, for line charts
+    bool GetCloseRange(size_t first, size_t last, double& low, double& high) const;
+
+private:
+    // Range query over lows/highs, or closeMins/closeMaxs when closes is set
+    bool GetRange(size_t first, size_t last, bool closes, double& low, double& high) const;
+
+    // Columns of one merged level
+    struct LevelData {
+        std::vector<double> timestamps;
+        std::vector<double> opens;
+        std::vector<double> highs;
+        std::vector<double> lows;
+        std::vector<double> closes;
+        std::vector<double> closeMins;
+        std::vector<double> closeMaxs;
+        std::vector<uint8_t> closeMinFirst;
+    };
+
+    // Merge runs of BASE_BARS_PER_BUCKET bars of the series into level 1, from bucket
+    // firstBucket on; those before it are kept
+    static void MergeBase(const OhlcvSpans& bars, LevelData& level, size_t firstBucket);
+
+    // Merge pairs of buckets of the level below into level, likewise
+    static void MergeLevel(const Level& below, LevelData& level, size_t firstBucket);
+
+    // Size a level's columns for count buckets; returns the first bucket to merge, which
+    // is no later than its old end
+    static size_t ResizeLevel(LevelData& level, size_t count, size_t firstBucket);
+
+    OhlcvSpans m_base;
+    std::vector<LevelData> m_levels;    // level k is m_levels[k - 1]
+};
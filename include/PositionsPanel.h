@@ -1,6 +1,7 @@
 #pragma once
 
 #include "imgui.h"
+#include "InstrumentRegistry.h"
 #include <string>
 #include <vector>
 #include <functional>
@@ -8,6 +9,7 @@
 // Position struct to represent a trading position
 struct Position {
     std::string symbol;
+    InstrumentId instrument = INVALID_INSTRUMENT;
     std::string type; // "Long" or "Short"
     double entryPrice;
     double amount;
@@ -31,7 +33,7 @@ public:
 
     // Position management
     void AddPosition(const Position& position);
-    void UpdatePositionPrice(const std::string& symbol, double price);
+    void UpdatePositionPrice(InstrumentId instrument, double price);
     void ClosePosition(size_t index);
 
     // Set callback for when positions are closed
@@ -47,6 +49,10 @@ private:
     // Positions data
     std::vector<Position> m_positions;
 
+    // Indexes into m_positions of the open positions, by instrument id, so a price
+    // update only visits the positions it moves
+    std::vector<std::vector<size_t>> m_openPositions;
+
     // Callback for position closing
     PositionCallback m_positionCloseCallback;
 
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "HttpTransport.h"
+#include "ConnectionPool.h"
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
+// Plain HTTP/1.1 transport for POSIX hosts, built on non-blocking sockets and epoll.
+// Lets the market-data path run headless on Linux build and benchmark machines
+// against a local mock server. Connections are kept alive per host and chunked
+// bodies are decoded; there is no TLS, so only http:// URLs are accepted.
+class PosixHttpTransport : public IHttpTransport {
+public:
+    PosixHttpTransport(size_t maxConnections = 8, int idleTimeoutSeconds = 60, int requestTimeoutSeconds = 10);
+    ~PosixHttpTransport() override;
+
+    PosixHttpTransport(const PosixHttpTransport&) = delete;
+    PosixHttpTransport& operator=(const PosixHttpTransport&) = delete;
+
+    // Make a GET request to a URL with custom headers
+    bool Get(
+        const std::string& url,
+        const std::map<std::string, std::string>& headers,
+        HttpResponse& response,
+        std::string& error
+    ) override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // A connected socket and the epoll instance that waits on it
+    struct Connection {
+        int socket = -1;
+        int epoll = -1;
+    };
+
+    // Connections are pooled per host and port
+    using ConnectionKey = std::pair<std::string, int>;
+
+    // Outcome of one request on one connection
+    enum class Exchange {
+        Done,
+        Failed,
+        // The (reused) connection was closed by the server before replying
+        Stale
+    };
+
+    Exchange Request(const Connection& connection, const std::string& request,
+        HttpResponse& response, bool& keepAlive, Clock::time_point deadline, std::string& error);
+
+    bool Connect(const std::string& host, int port, Connection& connection,
+        Clock::time_point deadline, std::string& error);
+    static void Close(Connection connection);
+
+    // Wait until the socket is ready for the given epoll events or the deadline passes
+    static bool WaitFor(const Connection& connection, uint32_t events, Clock::time_point deadline);
+
+    // Read whatever is available into data; returns bytes read, 0 on EOF, -1 on error or timeout
+    static long ReadSome(const Connection& connection, std::string& data, Clock::time_point deadline);
+
+    static bool SendAll(const Connection& connection, const std::string& data,
+        Clock::time_point deadline, std::string& error);
+
+    ConnectionPool<ConnectionKey, Connection> m_connections;
+    int m_requestTimeoutMs;
+};
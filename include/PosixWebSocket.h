@@ -0,0 +1,42 @@
+#pragma once
+
+#include "WebSocketTransport.h"
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <string>
+
+// WebSocket client (RFC 6455) over a plain POSIX socket, for running the market
+// feed headless against a local replay server. There is no TLS, so only ws:// URLs
+// are accepted.
+class PosixWebSocket : public IWebSocketConnection {
+public:
+    PosixWebSocket();
+    ~PosixWebSocket() override;
+
+    PosixWebSocket(const PosixWebSocket&) = delete;
+    PosixWebSocket& operator=(const PosixWebSocket&) = delete;
+
+    bool Connect(const std::string& url, int timeoutSeconds, std::string& error) override;
+    bool Send(const std::string& message, std::string& error) override;
+    bool Receive(std::string& message, std::string& error) override;
+    void Abort() override;
+
+private:
+    // Frame a payload (masked, as clients must) and write it out
+    bool SendFrame(uint8_t opcode, const std::string& payload, std::string& error);
+
+    bool WriteAll(const char* data, size_t size, std::string& error);
+
+    // Read exactly size bytes, waiting at most the receive timeout for each read
+    bool ReadExact(char* data, size_t size, std::string& error);
+
+    std::atomic<int> m_socket{ -1 };
+    int m_timeoutMs = 10000;
+
+    // Bytes received but not yet consumed (e.g. frames that followed the handshake)
+    std::string m_buffer;
+    size_t m_bufferPos = 0;
+
+    std::mt19937 m_maskGenerator;
+};
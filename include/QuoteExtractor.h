@@ -0,0 +1,37 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Fields pulled out of a cryptocurrency entry and its quote.USD object
+struct ExtractedQuote {
+    double price = 0.0;
+    double volume24h = 0.0;
+    double percentChange1h = 0.0;
+    double percentChange24h = 0.0;
+    double percentChange7d = 0.0;
+    double marketCap = 0.0;
+    std::string lastUpdated;
+};
+
+// Everything the extractor keeps from a response
+struct QuoteExtractionResult {
+    int errorCode = 0;
+    std::string errorMessage;
+
+    // Only the requested symbols that were present
+    std::map<std::string, ExtractedQuote> quotes;
+};
+
+// Streaming extractor for CoinMarketCap listings and quotes responses.
+// Runs nlohmann's SAX parser over the body and only keeps the status and the
+// quote.USD fields of the requested symbols; no DOM nodes are built for the
+// thousands of other rows, and parsing stops once every symbol has been seen.
+class QuoteExtractor {
+public:
+    // Returns false if the body is not valid JSON
+    static bool Extract(std::string_view json, const std::vector<std::string>& symbols,
+        QuoteExtractionResult& result);
+};
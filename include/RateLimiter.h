@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+
+// Remaining budget as seen by the limiter
+struct RateLimiterStats {
+    double requestsAvailable = 0.0;     // requests that may be sent right now
+    double creditsAvailable = 0.0;      // credits left in the per-minute budget
+    double creditsUsedToday = 0.0;
+    double creditsRemainingToday = 0.0;
+};
+
+// Rate limiter and credit budgeter for the market-data API.
+// Requests and credits per minute are token buckets that refill continuously;
+// credits per day are a fixed budget that resets at UTC midnight, like the provider's.
+// Background requests must leave a reserve of every budget for interactive ones.
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Decision {
+        Granted,    // budget spent; send the request
+        Wait,       // try again after retryAfter
+        Exhausted   // no daily budget left for this request
+    };
+
+    RateLimiter(double requestsPerMinute, double creditsPerMinute, double creditsPerDay,
+        double backgroundReserve);
+
+    // Spend one request and the given credits if the budget allows. A request costing more
+    // than a full bucket is let through once the bucket is full, leaving it in debt
+    Decision TryAcquire(double credits, bool isBackground, Clock::duration& retryAfter);
+
+    // Give back what a granted TryAcquire spent, for a request that was never sent
+    void Refund(double credits);
+
+    RateLimiterStats GetStats();
+
+private:
+    // Top up the buckets and roll the daily budget over (mutex held)
+    void Refill(Clock::time_point now);
+
+    double m_requestsPerMinute;
+    double m_creditsPerMinute;
+    double m_creditsPerDay;
+    double m_backgroundReserve;
+
+    double m_requestTokens;
+    double m_creditTokens;
+    double m_creditsUsedToday = 0.0;
+    long long m_currentDay;
+    Clock::time_point m_lastRefill;
+
+    std::mutex m_mutex;
+};
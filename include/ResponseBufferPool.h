@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Pool of response body buffers, kept per endpoint. Each endpoint's responses are
+// roughly the same size from one poll to the next, so a buffer handed back out is
+// already large enough and the transport reads into it without reallocating.
+class ResponseBufferPool {
+public:
+    // A buffer on loan from the pool; returned automatically when destroyed
+    class Buffer {
+    public:
+        Buffer() = default;
+
+        Buffer(Buffer&& other) noexcept
+            : m_pool(std::exchange(other.m_pool, nullptr)),
+              m_key(std::move(other.m_key)),
+              m_data(std::move(other.m_data)) {
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                Release();
+                m_pool = std::exchange(other.m_pool, nullptr);
+                m_key = std::move(other.m_key);
+                m_data = std::move(other.m_data);
+            }
+            return *this;
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        ~Buffer() {
+            Release();
+        }
+
+        // Storage for the transport to fill
+        std::string& Data() { return m_data; }
+
+        // Read-only view handed to parsers; valid until the buffer is released
+        std::string_view View() const { return m_data; }
+
+    private:
+        friend class ResponseBufferPool;
+
+        void Release() {
+            if (m_pool) {
+                m_pool->Return(m_key, std::move(m_data));
+                m_pool = nullptr;
+            }
+        }
+
+        ResponseBufferPool* m_pool = nullptr;
+        std::string m_key;
+        std::string m_data;
+    };
+
+    ResponseBufferPool() = default;
+    ResponseBufferPool(const ResponseBufferPool&) = delete;
+    ResponseBufferPool& operator=(const ResponseBufferPool&) = delete;
+
+    // Take an empty buffer for key, reserved to the size of its last response
+    Buffer Acquire(const std::string& key) {
+        Buffer buffer;
+        size_t sizeHint = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Slot& slot = m_slots[key];
+            sizeHint = slot.lastSize;
+
+            if (!slot.free.empty()) {
+                buffer.m_data = std::move(slot.free.back());
+                slot.free.pop_back();
+            }
+        }
+
+        buffer.m_pool = this;
+        buffer.m_key = key;
+        buffer.m_data.clear();
+
+        // A little headroom so a slightly larger response does not reallocate
+        buffer.m_data.reserve(sizeHint + sizeHint / 8);
+        return buffer;
+    }
+
+private:
+    // Spare buffers kept per endpoint; extras are freed
+    static constexpr size_t MAX_FREE_PER_KEY = 4;
+
+    struct Slot {
+        std::vector<std::string> free;
+        size_t lastSize = 0;
+    };
+
+    void Return(const std::string& key, std::string&& data) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Slot& slot = m_slots[key];
+
+        if (!data.empty()) {
+            slot.lastSize = data.size();
+        }
+        if (slot.free.size() < MAX_FREE_PER_KEY) {
+            slot.free.push_back(std::move(data));
+        }
+    }
+
+    std::mutex m_mutex;
+    std::map<std::string, Slot> m_slots;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// In-memory cache of API response bodies keyed by request URL.
+// Entries are fresh for a TTL chosen by the caller per endpoint and are served
+// without a round trip while fresh. Past their TTL they are kept (if the server
+// gave an ETag or Last-Modified) so the next request can be made conditional and
+// a 304 revalidates the stored body. Least recently used entries are evicted to
+// stay within the byte limit.
+class ResponseCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Body = std::shared_ptr<const std::string>;
+
+    // Cache validators from the response headers
+    struct Validators {
+        std::string etag;
+        std::string lastModified;
+
+        bool Empty() const { return etag.empty() && lastModified.empty(); }
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t revalidated = 0;   // 304 responses that refreshed an entry
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    explicit ResponseCache(size_t maxBytes);
+
+    // Body of a fresh entry (a hit), or null (a miss)
+    Body Lookup(const std::string& key);
+
+    // True if there is a fresh entry; not counted as a hit or miss
+    bool IsFresh(const std::string& key);
+
+    // Validators of an expired entry, for a conditional request; false if there are none
+    bool GetValidators(const std::string& key, Validators& validators);
+
+    // The server answered 304: the entry is fresh for another ttl. Returns its body,
+    // or null if it has been evicted meanwhile
+    Body Revalidate(const std::string& key, Clock::duration ttl);
+
+    // Store a 200 response, taking over the body. Returns the stored body, or null (with
+    // body left untouched) if it is too large to keep
+    Body Store(const std::string& key, std::string&& body, Validators validators, Clock::duration ttl);
+
+    Stats GetStats();
+
+private:
+    struct Entry {
+        Body body;
+        Validators validators;
+        Clock::time_point expires;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    // Mark the entry most recently used (mutex held)
+    void Touch(Entry& entry);
+
+    // Remove an entry (mutex held)
+    void Erase(std::unordered_map<std::string, Entry>::iterator it);
+
+    static size_t EntrySize(const std::string& key, size_t bodySize, const Validators& validators);
+
+    std::unordered_map<std::string, Entry> m_entries;
+    std::list<std::string> m_lru;   // front is most recently used
+    size_t m_bytes = 0;
+    size_t m_maxBytes;
+
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_revalidated = 0;
+
+    std::mutex m_mutex;
+};
@@ -1,22 +1,65 @@
 #pragma once
 
+#include "HttpTransport.h"
+#include "ConnectionPool.h"
 #include <string>
 #include <map>
-#include <functional>
+#include <cctype>
+#include <utility>
 #include <windows.h>
 #include <winhttp.h>
 
 #pragma comment(lib, "winhttp.lib")
 
-class SimpleHttpClient {
+// WinHTTP transport with a process-lifetime session and a pool of keep-alive
+// connections per host. WinHTTP keeps the underlying sockets open for as long
+// as the session and connection handles live, so reusing them skips the
+// TCP+TLS handshake on every call after the first.
+class SimpleHttpClient : public IHttpTransport {
 public:
+    SimpleHttpClient(size_t maxConnections = 8, int idleTimeoutSeconds = 60, int requestTimeoutSeconds = 10)
+        : m_connections(maxConnections, idleTimeoutSeconds, [](HINTERNET handle) { WinHttpCloseHandle(handle); }),
+          m_requestTimeoutMs(static_cast<DWORD>(requestTimeoutSeconds) * 1000) {
+        // One session for the lifetime of the client
+        m_session = WinHttpOpen(
+            L"TradingPlatform/1.0",
+            WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+            WINHTTP_NO_PROXY_NAME,
+            WINHTTP_NO_PROXY_BYPASS,
+            0
+        );
+
+        if (m_session) {
+            DWORD maxConns = static_cast<DWORD>(maxConnections);
+            WinHttpSetOption(m_session, WINHTTP_OPTION_MAX_CONNS_PER_SERVER, &maxConns, sizeof(maxConns));
+        }
+    }
+
+    ~SimpleHttpClient() override {
+        // Connection handles must be closed before the session that owns them
+        m_connections.CloseAll();
+
+        if (m_session) {
+            WinHttpCloseHandle(m_session);
+            m_session = nullptr;
+        }
+    }
+
+    SimpleHttpClient(const SimpleHttpClient&) = delete;
+    SimpleHttpClient& operator=(const SimpleHttpClient&) = delete;
+
     // Make a GET request to a URL with custom headers
-    static bool Get(
+    bool Get(
         const std::string& url,
         const std::map<std::string, std::string>& headers,
-        std::string& response,
+        HttpResponse& response,
         std::string& error
-    ) {
+    ) override {
+        if (!m_session) {
+            error = "Failed to initialize WinHttp: " + GetLastErrorAsString();
+            return false;
+        }
+
         // Convert URL to wide string
         std::wstring wideUrl = StringToWideString(url);
 
@@ -41,34 +84,37 @@ public:
         // Determine if HTTPS
         bool isHttps = (urlComp.nScheme == INTERNET_SCHEME_HTTPS);
 
-        // Initialize WinHttp
-        HINTERNET hSession = WinHttpOpen(
-            L"TradingPlatform/1.0",
-            WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
-            WINHTTP_NO_PROXY_NAME,
-            WINHTTP_NO_PROXY_BYPASS,
-            0
-        );
-
-        if (!hSession) {
-            error = "Failed to initialize WinHttp: " + GetLastErrorAsString();
-            return false;
+        // Take a pooled connection to the server (or open a new one)
+        ConnectionKey key(hostName, urlComp.nPort);
+        HINTERNET hConnect = nullptr;
+        if (!m_connections.Acquire(key, hConnect)) {
+            hConnect = WinHttpConnect(m_session, hostName, urlComp.nPort, 0);
+            if (!hConnect) {
+                error = "Failed to connect to server: " + GetLastErrorAsString();
+                m_connections.Abandon();
+                return false;
+            }
         }
 
-        // Connect to server
-        HINTERNET hConnect = WinHttpConnect(
-            hSession,
-            hostName,
-            urlComp.nPort,
-            0
-        );
+        bool success = SendRequest(hConnect, urlPath, isHttps, headers, response, error);
 
-        if (!hConnect) {
-            error = "Failed to connect to server: " + GetLastErrorAsString();
-            WinHttpCloseHandle(hSession);
-            return false;
-        }
+        // Connections that failed mid-request are not worth keeping
+        m_connections.Release(key, hConnect, success);
+        return success;
+    }
+
+private:
+    // Connections are pooled per host and port
+    using ConnectionKey = std::pair<std::wstring, INTERNET_PORT>;
 
+    bool SendRequest(
+        HINTERNET hConnect,
+        const wchar_t* urlPath,
+        bool isHttps,
+        const std::map<std::string, std::string>& headers,
+        HttpResponse& response,
+        std::string& error
+    ) {
         // Create request
         HINTERNET hRequest = WinHttpOpenRequest(
             hConnect,
@@ -82,13 +128,11 @@ public:
 
         if (!hRequest) {
             error = "Failed to create request: " + GetLastErrorAsString();
-            WinHttpCloseHandle(hConnect);
-            WinHttpCloseHandle(hSession);
             return false;
         }
 
-        // Set request timeout (10 seconds)
-        DWORD timeout = 10000;
+        // Set request timeouts
+        DWORD timeout = m_requestTimeoutMs;
         WinHttpSetOption(hRequest, WINHTTP_OPTION_CONNECT_TIMEOUT, &timeout, sizeof(timeout));
         WinHttpSetOption(hRequest, WINHTTP_OPTION_SEND_TIMEOUT, &timeout, sizeof(timeout));
         WinHttpSetOption(hRequest, WINHTTP_OPTION_RECEIVE_TIMEOUT, &timeout, sizeof(timeout));
@@ -105,7 +149,7 @@ public:
         }
 
         // Send request
-        result = WinHttpSendRequest(
+        BOOL result = WinHttpSendRequest(
             hRequest,
             WINHTTP_NO_ADDITIONAL_HEADERS,
             0,
@@ -118,8 +162,6 @@ public:
         if (!result) {
             error = "Failed to send request: " + GetLastErrorAsString();
             WinHttpCloseHandle(hRequest);
-            WinHttpCloseHandle(hConnect);
-            WinHttpCloseHandle(hSession);
             return false;
         }
 
@@ -128,8 +170,6 @@ public:
         if (!result) {
             error = "Failed to receive response: " + GetLastErrorAsString();
             WinHttpCloseHandle(hRequest);
-            WinHttpCloseHandle(hConnect);
-            WinHttpCloseHandle(hSession);
             return false;
         }
 
@@ -144,52 +184,107 @@ public:
             &statusCodeSize,
             WINHTTP_NO_HEADER_INDEX
         );
+        response.statusCode = static_cast<int>(statusCode);
 
-        if (statusCode != 200) {
-            error = "HTTP error: " + std::to_string(statusCode);
-            WinHttpCloseHandle(hRequest);
-            WinHttpCloseHandle(hConnect);
-            WinHttpCloseHandle(hSession);
-            return false;
+        // Header fields, for Retry-After and cache validators
+        response.headers.clear();
+        DWORD headersSize = 0;
+        WinHttpQueryHeaders(
+            hRequest,
+            WINHTTP_QUERY_RAW_HEADERS_CRLF,
+            WINHTTP_HEADER_NAME_BY_INDEX,
+            WINHTTP_NO_OUTPUT_BUFFER,
+            &headersSize,
+            WINHTTP_NO_HEADER_INDEX
+        );
+        if (headersSize > 0) {
+            std::wstring rawHeaders(headersSize / sizeof(wchar_t), L'\0');
+            if (WinHttpQueryHeaders(
+                hRequest,
+                WINHTTP_QUERY_RAW_HEADERS_CRLF,
+                WINHTTP_HEADER_NAME_BY_INDEX,
+                &rawHeaders[0],
+                &headersSize,
+                WINHTTP_NO_HEADER_INDEX
+            )) {
+                rawHeaders.resize(headersSize / sizeof(wchar_t));
+                ParseRawHeaders(WideStringToString(rawHeaders), response.headers);
+            }
+        }
+
+        // Size the body up front from Content-Length when the server sends one;
+        // otherwise rely on the capacity the (pooled) buffer kept from earlier responses
+        response.body.clear();
+        DWORD contentLength = 0;
+        DWORD contentLengthSize = sizeof(contentLength);
+        bool hasContentLength = WinHttpQueryHeaders(
+            hRequest,
+            WINHTTP_QUERY_CONTENT_LENGTH | WINHTTP_QUERY_FLAG_NUMBER,
+            WINHTTP_HEADER_NAME_BY_INDEX,
+            &contentLength,
+            &contentLengthSize,
+            WINHTTP_NO_HEADER_INDEX
+        ) != FALSE;
+        if (hasContentLength) {
+            response.body.reserve(contentLength);
         }
 
-        // Read response data
-        response.clear();
+        // Read response data straight into the tail of the body; the body must be
+        // drained fully for the socket to be reused
         DWORD bytesAvailable = 0;
         DWORD bytesRead = 0;
-        char buffer[4096] = { 0 };
 
-        do {
+        while (true) {
             bytesAvailable = 0;
-            result = WinHttpQueryDataAvailable(hRequest, &bytesAvailable);
+            if (!WinHttpQueryDataAvailable(hRequest, &bytesAvailable)) {
+                error = "Failed to receive response: " + GetLastErrorAsString();
+                WinHttpCloseHandle(hRequest);
+                return false;
+            }
 
-            if (!result || bytesAvailable == 0) {
+            if (bytesAvailable == 0) {
                 break;
             }
 
-            ZeroMemory(buffer, sizeof(buffer));
+            size_t offset = response.body.size();
+            response.body.resize(offset + bytesAvailable);
 
-            if (WinHttpReadData(
+            bytesRead = 0;
+            result = WinHttpReadData(
                 hRequest,
-                buffer,
-                sizeof(buffer) - 1,
+                &response.body[offset],
+                bytesAvailable,
                 &bytesRead
-            )) {
-                if (bytesRead > 0) {
-                    response.append(buffer, bytesRead);
-                }
+            );
+
+            response.body.resize(offset + bytesRead);
+
+            if (!result) {
+                error = "Failed to receive response: " + GetLastErrorAsString();
+                WinHttpCloseHandle(hRequest);
+                return false;
             }
-        } while (bytesAvailable > 0);
+        }
 
         // Clean up
         WinHttpCloseHandle(hRequest);
-        WinHttpCloseHandle(hConnect);
-        WinHttpCloseHandle(hSession);
+
+        // A body cut short is a failed request, not a short success
+        if (hasContentLength && response.body.size() < contentLength) {
+            error = "Truncated response body";
+            return false;
+        }
 
         return true;
     }
 
-private:
+    // Session shared by every request
+    HINTERNET m_session = nullptr;
+
+    // Keep-alive connection handles
+    ConnectionPool<ConnectionKey, HINTERNET> m_connections;
+    DWORD m_requestTimeoutMs;
+
     // Utility function to convert string to wide string
     static std::wstring StringToWideString(const std::string& str) {
         if (str.empty()) {
@@ -202,6 +297,42 @@ private:
         return result;
     }
 
+    // Utility function to convert wide string to string
+    static std::string WideStringToString(const std::wstring& str) {
+        if (str.empty()) {
+            return std::string();
+        }
+
+        int size = WideCharToMultiByte(CP_UTF8, 0, str.c_str(), (int)str.length(), NULL, 0, NULL, NULL);
+        std::string result(size, 0);
+        WideCharToMultiByte(CP_UTF8, 0, str.c_str(), (int)str.length(), &result[0], size, NULL, NULL);
+        return result;
+    }
+
+    // Split a CRLF header block (after the status line) into lower-cased names and trimmed values
+    static void ParseRawHeaders(const std::string& raw, std::map<std::string, std::string>& headers) {
+        size_t pos = raw.find("\r\n");
+        while (pos != std::string::npos && pos + 2 < raw.size()) {
+            size_t lineStart = pos + 2;
+            pos = raw.find("\r\n", lineStart);
+            std::string line = raw.substr(lineStart, pos == std::string::npos ? std::string::npos : pos - lineStart);
+
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+
+            std::string name = line.substr(0, colon);
+            for (auto& c : name) {
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+
+            size_t valueStart = line.find_first_not_of(" \t", colon + 1);
+            size_t valueEnd = line.find_last_not_of(" \t");
+            headers[name] = valueStart == std::string::npos ? std::string() : line.substr(valueStart, valueEnd - valueStart + 1);
+        }
+    }
+
     // Utility function to get the last error as string
     static std::string GetLastErrorAsString() {
         DWORD error = GetLastError();
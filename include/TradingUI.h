@@ -5,10 +5,13 @@
 #include "ChartPanel.h"
 #include "PositionsPanel.h"
 #include "TradingPanel.h"
+#include "MarketState.h"
 #include <memory>
+#include <vector>
 #include "imgui_internal.h" 
 
 class CryptoAPIClient;
+class MarketFeed;
 
 class TradingUI {
 public:
@@ -18,6 +21,10 @@ public:
     void Initialize();
     void Render();
     void SetAPIClient(std::shared_ptr<CryptoAPIClient> apiClient);
+
+    // Take prices pushed by the feed; quote polling is skipped while it is live
+    void SetMarketFeed(std::shared_ptr<MarketFeed> marketFeed);
+
     void UpdatePriceData();
 
 private:
@@ -27,6 +34,12 @@ private:
     void LoadFonts();
     void RenderMenuBar();
 
+    // Record a quote from the API or the feed (called on the network threads)
+    void OnQuote(const PriceData& data, bool isRealData);
+
+    // Apply the quotes that changed since the last frame
+    void ApplyMarketSnapshot();
+
     // Execute trade logic
     void ExecuteTrade(bool isBuy, const std::string& symbol, double price, double amount);
 
@@ -45,6 +58,15 @@ private:
     // API client reference
     std::shared_ptr<CryptoAPIClient> m_apiClient;
 
+    // Push feed
+    std::shared_ptr<MarketFeed> m_marketFeed;
+
+    // Latest quotes handed over from the network threads, the newest version applied,
+    // and the instrument charted when it was
+    MarketState m_marketState;
+    uint64_t m_appliedVersion = 0;
+    InstrumentId m_chartedInstrument = INVALID_INSTRUMENT;
+
     // Font pointers
     ImFont* m_defaultFont = nullptr;
     ImFont* m_boldFont = nullptr;
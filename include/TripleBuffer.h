@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Lock-free handoff of the latest value from one writer thread to one reader thread.
+// The writer fills its buffer and publishes it; the reader picks up the newest
+// published buffer. Each side owns one of three buffers and the third sits in the
+// middle, swapped in with a single atomic exchange, so neither side ever waits for
+// the other and the reader always sees a complete value. Intermediate values the
+// reader never picked up are skipped.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer: the buffer to fill before the next Publish(); it holds an older value
+    T& GetWriteBuffer() { return m_buffers[m_writeIndex]; }
+
+    // Writer: hand the filled buffer to the reader
+    void Publish() {
+        int previous = m_middle.exchange(m_writeIndex | FRESH, std::memory_order_acq_rel);
+        m_writeIndex = previous & INDEX_MASK;
+    }
+
+    // Reader: the newest published value; it stays untouched until the next Acquire()
+    const T& Acquire() {
+        if (m_middle.load(std::memory_order_relaxed) & FRESH) {
+            int previous = m_middle.exchange(m_readIndex, std::memory_order_acq_rel);
+            m_readIndex = previous & INDEX_MASK;
+        }
+        return m_buffers[m_readIndex];
+    }
+
+private:
+    // The middle slot holds a buffer index, flagged when it is newer than the reader's
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int FRESH = 4;
+
+    std::array<T, 3> m_buffers{};
+    std::atomic<int> m_middle{ 1 };
+    int m_writeIndex = 0;
+    int m_readIndex = 2;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+// Interface for a client WebSocket connection used by MarketFeed, so the backend
+// can differ per platform (WinHTTP on Windows, plain sockets elsewhere). Messages
+// are whole text messages; pings are answered and fragments reassembled internally.
+class IWebSocketConnection {
+public:
+    virtual ~IWebSocketConnection() = default;
+
+    // Open the connection and complete the handshake. A Receive that sees nothing for
+    // timeoutSeconds fails, so a silent server is noticed
+    virtual bool Connect(const std::string& url, int timeoutSeconds, std::string& error) = 0;
+
+    // Send a text message
+    virtual bool Send(const std::string& message, std::string& error) = 0;
+
+    // Wait for the next message; false once the connection is closed, fails or times out
+    virtual bool Receive(std::string& message, std::string& error) = 0;
+
+    // Make a Receive blocked on another thread return; the connection is unusable afterwards
+    virtual void Abort() = 0;
+};
+
+// Create a connection for the platform's default backend
+std::unique_ptr<IWebSocketConnection> CreateWebSocketConnection();
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "WebSocketTransport.h"
+#include <atomic>
+#include <string>
+#include <windows.h>
+#include <winhttp.h>
+
+#pragma comment(lib, "winhttp.lib")
+
+// WebSocket client on WinHTTP's built-in WebSocket support, for ws:// and wss:// feeds.
+// Each connection owns its session; the feed keeps only one connection open.
+class WinHttpWebSocket : public IWebSocketConnection {
+public:
+    WinHttpWebSocket() = default;
+
+    ~WinHttpWebSocket() override {
+        // Close in reverse order of creation
+        if (m_webSocket) {
+            WinHttpCloseHandle(m_webSocket);
+        }
+        if (m_connect) {
+            WinHttpCloseHandle(m_connect);
+        }
+        if (m_session) {
+            WinHttpCloseHandle(m_session);
+        }
+    }
+
+    WinHttpWebSocket(const WinHttpWebSocket&) = delete;
+    WinHttpWebSocket& operator=(const WinHttpWebSocket&) = delete;
+
+    bool Connect(const std::string& url, int timeoutSeconds, std::string& error) override {
+        // WinHttpCrackUrl only knows the HTTP schemes
+        std::string httpUrl = url;
+        if (httpUrl.compare(0, 6, "wss://") == 0) {
+            httpUrl = "https://" + httpUrl.substr(6);
+        }
+        else if (httpUrl.compare(0, 5, "ws://") == 0) {
+            httpUrl = "http://" + httpUrl.substr(5);
+        }
+        std::wstring wideUrl = StringToWideString(httpUrl);
+
+        URL_COMPONENTS urlComp = { 0 };
+        urlComp.dwStructSize = sizeof(urlComp);
+
+        wchar_t hostName[256] = { 0 };
+        urlComp.lpszHostName = hostName;
+        urlComp.dwHostNameLength = sizeof(hostName) / sizeof(hostName[0]);
+
+        wchar_t urlPath[2048] = { 0 };
+        urlComp.lpszUrlPath = urlPath;
+        urlComp.dwUrlPathLength = sizeof(urlPath) / sizeof(urlPath[0]);
+
+        if (!WinHttpCrackUrl(wideUrl.c_str(), (DWORD)wideUrl.length(), 0, &urlComp)) {
+            error = "Failed to parse URL: " + url;
+            return false;
+        }
+
+        m_session = WinHttpOpen(L"TradingPlatform/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+            WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+        if (!m_session) {
+            error = "Failed to initialize WinHttp";
+            return false;
+        }
+
+        // The receive timeout carries over to the upgraded WebSocket, so a silent feed is noticed
+        int timeoutMs = timeoutSeconds * 1000;
+        WinHttpSetTimeouts(m_session, timeoutMs, timeoutMs, timeoutMs, timeoutMs);
+
+        m_connect = WinHttpConnect(m_session, hostName, urlComp.nPort, 0);
+        if (!m_connect) {
+            error = "Failed to connect to server";
+            return false;
+        }
+
+        HINTERNET request = WinHttpOpenRequest(m_connect, L"GET", urlPath, NULL, WINHTTP_NO_REFERER,
+            WINHTTP_DEFAULT_ACCEPT_TYPES, urlComp.nScheme == INTERNET_SCHEME_HTTPS ? WINHTTP_FLAG_SECURE : 0);
+        if (!request) {
+            error = "Failed to create request";
+            return false;
+        }
+
+        DWORD statusCode = 0;
+        DWORD statusCodeSize = sizeof(statusCode);
+        bool upgraded =
+            WinHttpSetOption(request, WINHTTP_OPTION_UPGRADE_TO_WEB_SOCKET, NULL, 0) &&
+            WinHttpSendRequest(request, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0, 0) &&
+            WinHttpReceiveResponse(request, NULL) &&
+            WinHttpQueryHeaders(request, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                WINHTTP_HEADER_NAME_BY_INDEX, &statusCode, &statusCodeSize, WINHTTP_NO_HEADER_INDEX) &&
+            statusCode == 101;
+
+        if (upgraded) {
+            m_webSocket = WinHttpWebSocketCompleteUpgrade(request, 0);
+        }
+        WinHttpCloseHandle(request);
+
+        if (!m_webSocket) {
+            error = "WebSocket upgrade failed (HTTP " + std::to_string(statusCode) + ")";
+            return false;
+        }
+        return true;
+    }
+
+    bool Send(const std::string& message, std::string& error) override {
+        DWORD result = WinHttpWebSocketSend(m_webSocket, WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE,
+            (PVOID)message.data(), (DWORD)message.size());
+        if (result != ERROR_SUCCESS) {
+            error = "WebSocket send failed: " + std::to_string(result);
+            return false;
+        }
+        return true;
+    }
+
+    bool Receive(std::string& message, std::string& error) override {
+        message.clear();
+
+        // Fragments are appended until the final one of the message
+        char buffer[16 * 1024];
+        for (;;) {
+            if (m_aborted) {
+                error = "WebSocket aborted";
+                return false;
+            }
+
+            DWORD bytesRead = 0;
+            WINHTTP_WEB_SOCKET_BUFFER_TYPE bufferType;
+            DWORD result = WinHttpWebSocketReceive(m_webSocket, buffer, sizeof(buffer), &bytesRead, &bufferType);
+            if (result != ERROR_SUCCESS) {
+                error = "WebSocket receive failed: " + std::to_string(result);
+                return false;
+            }
+
+            if (bufferType == WINHTTP_WEB_SOCKET_CLOSE_BUFFER_TYPE) {
+                error = "WebSocket closed by server";
+                return false;
+            }
+
+            message.append(buffer, bytesRead);
+            if (bufferType == WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE ||
+                bufferType == WINHTTP_WEB_SOCKET_BINARY_MESSAGE_BUFFER_TYPE) {
+                return true;
+            }
+        }
+    }
+
+    void Abort() override {
+        // Starting the close handshake completes a pending receive with the close frame;
+        // failing that, it returns at the receive timeout
+        m_aborted = true;
+        if (m_webSocket) {
+            WinHttpWebSocketShutdown(m_webSocket, WINHTTP_WEB_SOCKET_SUCCESS_CLOSE_STATUS, NULL, 0);
+        }
+    }
+
+private:
+    static std::wstring StringToWideString(const std::string& str) {
+        if (str.empty()) {
+            return std::wstring();
+        }
+
+        int size = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), (int)str.length(), NULL, 0);
+        std::wstring result(size, 0);
+        MultiByteToWideChar(CP_UTF8, 0, str.c_str(), (int)str.length(), &result[0], size);
+        return result;
+    }
+
+    HINTERNET m_session = nullptr;
+    HINTERNET m_connect = nullptr;
+    HINTERNET m_webSocket = nullptr;
+    std::atomic<bool> m_aborted{ false };
+};
@@ -80,6 +80,12 @@ bool App::Initialize(HWND hwnd) {
     // Set the API client in the UI
     m_ui->SetAPIClient(m_apiClient);
 
+    // Stream prices from the feed when one is configured; polling covers for it otherwise
+    if (!Config::API::FEED_URL.empty()) {
+        m_marketFeed = std::make_shared<MarketFeed>(Config::API::FEED_URL);
+        m_ui->SetMarketFeed(m_marketFeed);
+    }
+
     // Initialize UI
     m_ui->Initialize();
 
@@ -94,6 +100,11 @@ void App::Shutdown() {
     if (!m_initialized)
         return;
 
+    // Stop the feed before the UI its callback feeds
+    if (m_marketFeed) {
+        m_marketFeed->Stop();
+    }
+
     // Shutdown API client
     if (m_apiClient) {
         m_apiClient->Shutdown();
@@ -0,0 +1,185 @@
+#include "BarStore.h"
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <system_error>
+#include <utility>
+
+namespace {
+    const char FILE_MAGIC[4] = { 'D', 'T', 'B', 'S' };
+    const uint32_t FILE_VERSION = 1;
+    const uint32_t FLAG_UNAVAILABLE = 1;
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t reserved;
+    };
+
+    struct Record {
+        int64_t timestamp;
+        uint32_t flags;
+        uint32_t reserved;
+        double open;
+        double high;
+        double low;
+        double close;
+        double volume;
+    };
+
+    static_assert(sizeof(FileHeader) == 16, "unexpected bar file header layout");
+    static_assert(sizeof(Record) == 56, "unexpected bar record layout");
+
+    FileHeader MakeHeader() {
+        FileHeader header = {};
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = FILE_VERSION;
+        header.recordSize = sizeof(Record);
+        return header;
+    }
+
+    Record ToRecord(const BarStore::Bar& bar) {
+        Record record = {};
+        record.timestamp = bar.timestamp;
+        record.flags = bar.unavailable ? FLAG_UNAVAILABLE : 0;
+        record.open = bar.open;
+        record.high = bar.high;
+        record.low = bar.low;
+        record.close = bar.close;
+        record.volume = bar.volume;
+        return record;
+    }
+
+    BarStore::Bar FromRecord(const Record& record) {
+        BarStore::Bar bar;
+        bar.timestamp = record.timestamp;
+        bar.unavailable = (record.flags & FLAG_UNAVAILABLE) != 0;
+        bar.open = record.open;
+        bar.high = record.high;
+        bar.low = record.low;
+        bar.close = record.close;
+        bar.volume = record.volume;
+        return bar;
+    }
+}
+
+BarStore::BarStore(std::string directory)
+    : m_directory(std::move(directory)) {
+}
+
+std::string BarStore::GetPath(const std::string& symbol, const std::string& interval) const {
+    // Keep the file name to characters that are safe on every filesystem
+    std::string name;
+    for (char c : symbol + "_" + interval) {
+        name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    return (std::filesystem::path(m_directory) / (name + ".bars")).string();
+}
+
+bool BarStore::Load(const std::string& symbol, const std::string& interval, int64_t keepFrom,
+    std::vector<Bar>& bars) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    bars.clear();
+    std::string path = GetPath(symbol, interval);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    FileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+        header.version != FILE_VERSION || header.recordSize != sizeof(Record)) {
+        // Start over rather than appending to a file we cannot read back
+        file.close();
+        Rewrite(path, bars);
+        return false;
+    }
+
+    // Read every record; later writes for a timestamp win
+    std::map<int64_t, Bar> latest;
+    size_t recordCount = 0;
+    Record record;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        recordCount++;
+        if (record.timestamp >= keepFrom) {
+            latest[record.timestamp] = FromRecord(record);
+        }
+    }
+    bool tornTail = file.gcount() != 0;
+    file.close();
+
+    bars.reserve(latest.size());
+    for (const auto& entry : latest) {
+        bars.push_back(entry.second);
+    }
+
+    // Drop expired and superseded records once they make up half the file, and
+    // never append after a partial record
+    if (tornTail || recordCount > 2 * bars.size() + 8) {
+        Rewrite(path, bars);
+    }
+
+    return true;
+}
+
+bool BarStore::Append(const std::string& symbol, const std::string& interval, const std::vector<Bar>& bars) {
+    if (bars.empty()) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+
+    std::string path = GetPath(symbol, interval);
+    bool isNew = !std::filesystem::exists(path, error) || std::filesystem::file_size(path, error) == 0;
+
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    if (isNew) {
+        FileHeader header = MakeHeader();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    for (const auto& bar : bars) {
+        Record record = ToRecord(bar);
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+
+    return static_cast<bool>(file.flush());
+}
+
+bool BarStore::Rewrite(const std::string& path, const std::vector<Bar>& bars) {
+    // Write a fresh file alongside and swap it in, so a crash leaves one of the two intact
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        FileHeader header = MakeHeader();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& bar : bars) {
+            Record record = ToRecord(bar);
+            file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+
+        if (!file.flush()) {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    return !error;
+}
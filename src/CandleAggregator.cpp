@@ -0,0 +1,166 @@
+#include "CandleAggregator.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+    // Start of the interval holding a timestamp
+    double GetBucketStart(double timestamp, int64_t intervalSeconds) {
+        double length = static_cast<double>(intervalSeconds);
+        return std::floor(timestamp / length) * length;
+    }
+}
+
+CandleAggregator::CandleAggregator(size_t capacity)
+    : m_capacity(capacity) {
+}
+
+int64_t CandleAggregator::GetIntervalSeconds(CandleInterval interval) {
+    switch (interval) {
+    case CandleInterval::OneMinute:      return 60;
+    case CandleInterval::FiveMinutes:    return 5 * 60;
+    case CandleInterval::FifteenMinutes: return 15 * 60;
+    case CandleInterval::OneHour:        return 60 * 60;
+    case CandleInterval::OneDay:         return 24 * 60 * 60;
+    }
+    return 24 * 60 * 60;
+}
+
+const char* CandleAggregator::GetIntervalLabel(CandleInterval interval) {
+    switch (interval) {
+    case CandleInterval::OneMinute:      return "1m";
+    case CandleInterval::FiveMinutes:    return "5m";
+    case CandleInterval::FifteenMinutes: return "15m";
+    case CandleInterval::OneHour:        return "1h";
+    case CandleInterval::OneDay:         return "1D";
+    }
+    return "";
+}
+
+void CandleAggregator::CandleColumns::Append(double timestamp, double open, double high, double low,
+    double close, double volume) {
+    timestamps.push_back(timestamp);
+    opens.push_back(open);
+    highs.push_back(high);
+    lows.push_back(low);
+    closes.push_back(close);
+    volumes.push_back(volume);
+}
+
+void CandleAggregator::CandleColumns::KeepNewest(size_t count) {
+    if (Size() <= count) {
+        return;
+    }
+    size_t dropped = Size() - count;
+    for (std::vector<double>* column : { &timestamps, &opens, &highs, &lows, &closes, &volumes }) {
+        column->erase(column->begin(), column->begin() + dropped);
+    }
+}
+
+CandleAggregator::SymbolCandles& CandleAggregator::GetInstrument(InstrumentId instrument) {
+    if (instrument >= m_instruments.size()) {
+        m_instruments.resize(instrument + 1);
+    }
+    return m_instruments[instrument];
+}
+
+void CandleAggregator::AddTick(InstrumentId instrument, double timestamp, double price, double volume) {
+    if (instrument == INVALID_INSTRUMENT || price <= 0.0) {
+        return;
+    }
+
+    SymbolCandles& candles = GetInstrument(instrument);
+
+    bool changed = false;
+    for (size_t i = 0; i < CANDLE_INTERVAL_COUNT; i++) {
+        CandleColumns& series = candles.series[i];
+        double bucket = GetBucketStart(timestamp, GetIntervalSeconds(static_cast<CandleInterval>(i)));
+
+        if (series.Size() == 0 || bucket > series.timestamps.back()) {
+            // First tick of a new interval opens the next candle; the oldest half goes
+            // once twice the capacity is held
+            series.Append(bucket, price, price, price, price, volume);
+            if (series.Size() >= 2 * m_capacity) {
+                series.KeepNewest(m_capacity);
+                candles.layout++;
+            }
+            changed = true;
+        }
+        else if (bucket == series.timestamps.back()) {
+            series.highs.back() = std::max(series.highs.back(), price);
+            series.lows.back() = std::min(series.lows.back(), price);
+            series.closes.back() = price;
+            series.volumes.back() += volume;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        candles.version++;
+    }
+}
+
+void CandleAggregator::Seed(InstrumentId instrument, CandleInterval interval, const BarSeries& history) {
+    if (instrument == INVALID_INSTRUMENT) {
+        return;
+    }
+
+    SymbolCandles& symbolCandles = GetInstrument(instrument);
+    CandleColumns& series = symbolCandles.series[static_cast<size_t>(interval)];
+    int64_t intervalSeconds = GetIntervalSeconds(interval);
+
+    // Candles built from ticks that the history does not cover yet
+    CandleColumns live = std::move(series);
+    series = CandleColumns();
+
+    for (size_t i = 0; i < history.Size(); i++) {
+        double timestamp = GetBucketStart(static_cast<double>(history.GetTimestamps()[i]), intervalSeconds);
+        if (series.Size() > 0 && timestamp <= series.timestamps.back()) {
+            continue;
+        }
+        series.Append(timestamp, history.GetOpens()[i], history.GetHighs()[i], history.GetLows()[i],
+            history.GetCloses()[i], history.GetVolumes()[i]);
+    }
+
+    for (size_t i = 0; i < live.Size(); i++) {
+        if (series.Size() == 0 || live.timestamps[i] > series.timestamps.back()) {
+            series.Append(live.timestamps[i], live.opens[i], live.highs[i], live.lows[i],
+                live.closes[i], live.volumes[i]);
+        }
+        else if (live.timestamps[i] == series.timestamps.back()) {
+            // The history's last candle is still open; fold in what the ticks saw since
+            series.highs.back() = std::max(series.highs.back(), live.highs[i]);
+            series.lows.back() = std::min(series.lows.back(), live.lows[i]);
+            series.closes.back() = live.closes[i];
+        }
+    }
+    series.KeepNewest(m_capacity);
+
+    symbolCandles.version++;
+    symbolCandles.layout++;
+}
+
+OhlcvColumns CandleAggregator::GetCandles(InstrumentId instrument, CandleInterval interval) const {
+    OhlcvColumns columns;
+    if (instrument >= m_instruments.size()) {
+        return columns;
+    }
+
+    const CandleColumns& series = m_instruments[instrument].series[static_cast<size_t>(interval)];
+    columns.timestamps = series.timestamps.data();
+    columns.opens = series.opens.data();
+    columns.highs = series.highs.data();
+    columns.lows = series.lows.data();
+    columns.closes = series.closes.data();
+    columns.volumes = series.volumes.data();
+    columns.count = series.Size();
+    return columns;
+}
+
+uint64_t CandleAggregator::GetVersion(InstrumentId instrument) const {
+    return instrument < m_instruments.size() ? m_instruments[instrument].version : 0;
+}
+
+uint64_t CandleAggregator::GetLayout(InstrumentId instrument) const {
+    return instrument < m_instruments.size() ? m_instruments[instrument].layout : 0;
+}
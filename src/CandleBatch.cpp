@@ -0,0 +1,32 @@
+#include "CandleBatch.h"
+#include <algorithm>
+
+void CandleBatch::Draw(ImDrawList* drawList, ImU32 bullColor, ImU32 bearColor) const {
+    size_t count = m_x.size();
+
+    // Wicks first, so the bodies are drawn over them. Pixel y grows downwards, so a bar
+    // closed above its open has the smaller close coordinate
+    for (size_t start = 0; start < count; start += RECTS_PER_RESERVE) {
+        size_t end = std::min(count, start + RECTS_PER_RESERVE);
+        drawList->PrimReserve(static_cast<int>(end - start) * 6, static_cast<int>(end - start) * 4);
+        for (size_t i = start; i < end; i++) {
+            ImU32 color = m_close[i] <= m_open[i] ? bullColor : bearColor;
+            drawList->PrimRect(ImVec2(m_x[i] - 0.5f, m_high[i]), ImVec2(m_x[i] + 0.5f, m_low[i]), color);
+        }
+    }
+
+    for (size_t start = 0; start < count; start += RECTS_PER_RESERVE) {
+        size_t end = std::min(count, start + RECTS_PER_RESERVE);
+        drawList->PrimReserve(static_cast<int>(end - start) * 6, static_cast<int>(end - start) * 4);
+        for (size_t i = start; i < end; i++) {
+            bool bullish = m_close[i] <= m_open[i];
+            float top = bullish ? m_close[i] : m_open[i];
+            float bottom = bullish ? m_open[i] : m_close[i];
+
+            // A bar that opened and closed at the same price still shows a line
+            bottom = std::max(bottom, top + 1.0f);
+            drawList->PrimRect(ImVec2(m_x[i] - m_halfWidth, top), ImVec2(m_x[i] + m_halfWidth, bottom),
+                bullish ? bullColor : bearColor);
+        }
+    }
+}
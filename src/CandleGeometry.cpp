@@ -0,0 +1,67 @@
+#include "CandleGeometry.h"
+#include <algorithm>
+#include <cmath>
+
+void CandleGeometry::Build(const OhlcvColumns& columns, size_t first, size_t last, double candleWidth,
+    const PlotTransform& transform) {
+    last = std::min(last, columns.count);
+    first = std::min(first, last);
+
+    Resize(last - first);
+    Map(columns, first, last, 0, transform);
+    SetWidth(candleWidth, transform);
+}
+
+void CandleGeometry::Build(const OhlcvSpans& bars, size_t first, size_t last, double candleWidth,
+    const PlotTransform& transform) {
+    last = std::min(last, bars.Count());
+    first = std::min(first, last);
+
+    Resize(last - first);
+    size_t at = 0;
+    bars.ForEachPart(first, last, [&](const OhlcvColumns& part, size_t from, size_t to) {
+        Map(part, from, to, at, transform);
+        at += to - from;
+    });
+    SetWidth(candleWidth, transform);
+}
+
+void CandleGeometry::Resize(size_t count) {
+    m_x.resize(count);
+    m_open.resize(count);
+    m_close.resize(count);
+    m_high.resize(count);
+    m_low.resize(count);
+}
+
+void CandleGeometry::Map(const OhlcvColumns& columns, size_t first, size_t last, size_t at,
+    const PlotTransform& transform) {
+    size_t count = last - first;
+
+    // Straight-line loops over contiguous columns, which the compiler vectorizes
+    const double* timestamps = columns.timestamps + first;
+    float* x = m_x.data() + at;
+    for (size_t i = 0; i < count; i++) {
+        x[i] = static_cast<float>(transform.originX + timestamps[i] * transform.scaleX);
+    }
+
+    const double* opens = columns.opens + first;
+    const double* closes = columns.closes + first;
+    const double* highs = columns.highs + first;
+    const double* lows = columns.lows + first;
+    float* open = m_open.data() + at;
+    float* close = m_close.data() + at;
+    float* high = m_high.data() + at;
+    float* low = m_low.data() + at;
+    for (size_t i = 0; i < count; i++) {
+        open[i] = static_cast<float>(transform.originY + opens[i] * transform.scaleY);
+        close[i] = static_cast<float>(transform.originY + closes[i] * transform.scaleY);
+        high[i] = static_cast<float>(transform.originY + highs[i] * transform.scaleY);
+        low[i] = static_cast<float>(transform.originY + lows[i] * transform.scaleY);
+    }
+}
+
+void CandleGeometry::SetWidth(double candleWidth, const PlotTransform& transform) {
+    // Bodies stay at least a pixel wide however far the chart is zoomed out
+    m_halfWidth = std::max(0.5f, static_cast<float>(candleWidth * std::abs(transform.scaleX) * 0.5));
+}
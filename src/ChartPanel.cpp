@@ -1,24 +1,31 @@
 #include "ChartPanel.h"
 #include "CryptoAPIClient.h"
 #include "Config.h"
+#include "ColumnarBarFile.h"
+#include "DebugLog.h"
 #include "imgui.h"
 #include "implot.h"
 #include <algorithm>
-#include <sstream>
-#include <Windows.h>
-#include <iostream>
+#include <ctime>
+#include <system_error>
 
-ChartPanel::ChartPanel() {
+ChartPanel::ChartPanel()
+    : m_candles(Config::UI::CANDLE_CAPACITY) {
     // Initialize available symbols from Config
     for (int i = 0; i < Config::UI::AVAILABLE_CRYPTOS_COUNT; i++) {
         m_availableSymbols.push_back(Config::UI::AVAILABLE_CRYPTOS[i]);
     }
 
     m_symbol = Config::UI::DEFAULT_CRYPTO;
+    m_instrument = InstrumentRegistry::Instance().Intern(m_symbol);
 }
 
 ChartPanel::~ChartPanel() {
-    // Nothing to clean up
+    // Keep the minute candles built this session for the next one
+    DrainTicks();
+    for (const auto& symbol : m_availableSymbols) {
+        SaveMinuteHistory(symbol);
+    }
 }
 
 void ChartPanel::Initialize(ImFont* boldFont) {
@@ -39,6 +46,10 @@ void ChartPanel::Render() {
     ImGui::SameLine();
     ImGui::Text("Price Chart");
 
+    // Interval selector
+    ImGui::SameLine();
+    RenderIntervalSelector();
+
     // Status indicators and price display
     ImGui::SameLine(ImGui::GetWindowWidth() - 250);
 
@@ -57,6 +68,11 @@ void ChartPanel::Render() {
 
     ImGui::Spacing();
 
+    // Pick up any ticks and historical data that arrived since the last frame
+    DrainTicks();
+    DrainHistoricalUpdates();
+    RefreshChart();
+
     // Animate price if needed
     AnimatePrice();
 
@@ -79,6 +95,14 @@ void ChartPanel::RenderSymbolSelector() {
             bool isSelected = (symbol == m_symbol);
             if (ImGui::Selectable(symbol.c_str(), isSelected)) {
                 if (symbol != m_symbol) {
+                    // Work still queued for the old symbol is no longer wanted
+                    if (m_apiClient) {
+                        m_apiClient->CancelRequestsFor(m_instrument);
+                    }
+
+                    // Its minute candles are shown with the saved history when it comes back
+                    SaveMinuteHistory(m_symbol);
+
                     SetSymbol(symbol);
 
                     // Update the chart data for the new symbol
@@ -114,6 +138,30 @@ void ChartPanel::RenderSymbolSelector() {
     }
 }
 
+void ChartPanel::RenderIntervalSelector() {
+    for (size_t i = 0; i < CANDLE_INTERVAL_COUNT; i++) {
+        CandleInterval interval = static_cast<CandleInterval>(i);
+        bool isSelected = (interval == m_interval);
+
+        if (i > 0) {
+            ImGui::SameLine(0.0f, 2.0f);
+        }
+
+        // Highlight the interval being shown
+        if (isSelected) {
+            ImGui::PushStyleColor(ImGuiCol_Button, ImGui::GetStyleColorVec4(ImGuiCol_ButtonActive));
+        }
+        if (ImGui::SmallButton(CandleAggregator::GetIntervalLabel(interval)) && !isSelected) {
+            // Every interval is kept up to date, so switching needs no request
+            m_interval = interval;
+            m_chartDirty = true;
+        }
+        if (isSelected) {
+            ImGui::PopStyleColor();
+        }
+    }
+}
+
 void ChartPanel::AnimatePrice() {
     // Gradually animate towards target price
     if (m_displayedPrice != m_targetPrice) {
@@ -136,7 +184,7 @@ void ChartPanel::SetAPIClient(std::shared_ptr<CryptoAPIClient> apiClient) {
     m_apiClient = apiClient;
 }
 
-void ChartPanel::UpdateChartData(const std::string& symbol) {
+void ChartPanel::UpdateChartData(const std::string& symbol, bool fetchQuote, RequestPriority priority) {
     if (!m_apiClient) {
         m_errorMessage = "API client not initialized";
         return;
@@ -149,70 +197,233 @@ void ChartPanel::UpdateChartData(const std::string& symbol) {
     // Update chart symbol
     m_chartRenderer.SetSymbol(symbol);
 
-    // Fetch historical data for the chart
-    m_apiClient->FetchHistoricalData(symbol, [this](const std::vector<PriceData>& historicalData) {
+    // A long minute-bar history saved in columnar form is plotted straight from the mapping.
+    // One appearing or going away changes what the 1m chart shows; a rewrite only extends it
+    bool hadMappedHistory = m_mappedHistory != nullptr;
+    if (OpenMappedHistory(symbol)) {
+        m_mappedHistoryChanged = true;
+        if ((m_mappedHistory != nullptr) != hadMappedHistory) {
+            m_chartDirty = true;
+        }
+    }
+
+    // Fetch daily history to seed the candles; the load runs on the request workers and
+    // partial series are handed back through the queue as days arrive
+    InstrumentId instrument = InstrumentRegistry::Instance().Intern(symbol);
+    m_apiClient->FetchHistoricalData(symbol, [this, instrument](const std::shared_ptr<const BarSeries>& series, bool isComplete) {
+        m_historicalUpdates.Push({ instrument, series, isComplete });
+        }, priority);
+
+    // Also fetch current price data for display, unless the caller batches quotes itself
+    if (fetchQuote && m_quoteCallback) {
+        m_apiClient->FetchLatestQuote(symbol, m_quoteCallback, priority);
+    }
+}
+
+void ChartPanel::ApplyQuote(InstrumentId instrument, const MarketQuote& quote) {
+    if (instrument != m_instrument) {
+        return;
+    }
+
+    m_targetPrice = quote.price;
+    m_priceChangeTime = ImGui::GetTime();
+    m_usingRealData = quote.isRealData;
+}
+
+void ChartPanel::AddTick(const PriceData& priceData) {
+    // REST quotes carry no timestamp of their own; they are as of now
+    double timestamp = priceData.timestamp > 0.0 ? priceData.timestamp : static_cast<double>(time(nullptr));
+
+    m_ticks.Push({ priceData.instrument, timestamp, priceData.price });
+}
+
+void ChartPanel::DrainTicks() {
+    // volume24h is a rolling total, not the quantity traded with a tick, so none is passed
+    CandleTick tick;
+    while (m_ticks.TryPop(tick)) {
+        m_candles.AddTick(tick.instrument, tick.timestamp, tick.price);
+    }
+}
+
+void ChartPanel::DrainHistoricalUpdates() {
+    m_historicalUpdates.Drain(m_drainedUpdates);
+
+    // Only the newest update for the current symbol matters; each one carries the whole series so far
+    const HistoricalUpdate* latest = nullptr;
+    for (const auto& update : m_drainedUpdates) {
+        if (update.instrument == m_instrument) {
+            latest = &update;
+        }
+    }
+
+    if (!latest) {
+        return;
+    }
+
+    // Until the new symbol's history is complete, the view follows it as it grows
+    if (m_fitHistory) {
+        m_chartDirty = true;
+        m_fitHistory = !latest->isComplete;
+    }
+
+    if (latest->isComplete) {
+        m_isLoading = false;
+
         // Skip if we didn't get any data
-        if (historicalData.empty()) {
+        if (latest->series->Empty()) {
             m_errorMessage = "No historical data received";
-            m_isLoading = false;
             return;
         }
+    }
 
-        // Prepare data vectors
-        std::vector<double> timestamps;
-        std::vector<double> opens;
-        std::vector<double> highs;
-        std::vector<double> lows;
-        std::vector<double> closes;
-        std::vector<double> volumes;
-
-        // Reserve space
-        timestamps.reserve(historicalData.size());
-        opens.reserve(historicalData.size());
-        highs.reserve(historicalData.size());
-        lows.reserve(historicalData.size());
-        closes.reserve(historicalData.size());
-        volumes.reserve(historicalData.size());
-
-        // Debug output
-        std::stringstream ss;
-        ss << "Processing " << historicalData.size() << " historical data points" << std::endl;
-        OutputDebugStringA(ss.str().c_str());
-
-        // Fill data vectors
-        for (const auto& data : historicalData) {
-            timestamps.push_back(data.timestamp);
-            opens.push_back(data.open);
-            highs.push_back(data.high);
-            lows.push_back(data.low);
-            closes.push_back(data.close);
-            volumes.push_back(data.volume);
-
-            // Debug last data point
-            if (&data == &historicalData.back()) {
-                std::stringstream debug;
-                debug << "Last data point - Date: " << data.timestamp
-                    << " Close: " << data.close << std::endl;
-                OutputDebugStringA(debug.str().c_str());
-            }
-        }
+    if (!latest->series->Empty()) {
+        ApplyHistoricalData(latest->instrument, *latest->series);
+    }
+}
 
-        // Update chart renderer with data
-        m_chartRenderer.SetChartData(timestamps, opens, highs, lows, closes, volumes);
-        m_isLoading = false;
-        });
+void ChartPanel::ApplyHistoricalData(InstrumentId instrument, const BarSeries& historicalData) {
+    // History is daily; today's candle keeps whatever the ticks have built so far
+    m_candles.Seed(instrument, CandleInterval::OneDay, historicalData);
+}
+
+void ChartPanel::RefreshChart() {
+    uint64_t version = m_candles.GetVersion(m_instrument);
+    if (!m_chartDirty && !m_mappedHistoryChanged && version == m_shownVersion) {
+        return;
+    }
 
-    // Also fetch current price data for display
-    m_apiClient->FetchLatestQuote(symbol, [this](const PriceData& priceData, bool isRealData) {
-        m_targetPrice = priceData.price;
-        m_priceChangeTime = ImGui::GetTime();
-        m_usingRealData = isRealData;
-        });
+    OhlcvSpans bars;
+    bars.head = m_candles.GetCandles(m_instrument, m_interval);
+
+    // At 1m the mapped minute history comes first, plotted in place, and the live candles
+    // carry on after its last bar
+    if (m_interval == CandleInterval::OneMinute && m_mappedHistory && m_mappedHistory->GetColumns().count > 0) {
+        const OhlcvColumns& saved = m_mappedHistory->GetColumns();
+        OhlcvColumns live = bars.head;
+        size_t newer = std::upper_bound(live.timestamps, live.timestamps + live.count,
+            saved.timestamps[saved.count - 1]) - live.timestamps;
+        bars.head = saved;
+        bars.tail = live.From(newer);
+    }
+
+    // Unless the candles were reseeded or trimmed, or the history remapped, since, the bars
+    // still start with the ones shown, and only the last of those can have changed
+    uint64_t layout = m_candles.GetLayout(m_instrument);
+    size_t firstChanged = 0;
+    if (!m_chartDirty && !m_mappedHistoryChanged && layout == m_shownLayout && m_shownCount > 0) {
+        firstChanged = m_shownCount - 1;
+    }
+
+    // The bars are drawn in place; a new symbol or interval is shown in full, and a tick
+    // keeps the user's zoom
+    m_chartRenderer.SetChartData(bars, firstChanged, m_chartDirty);
+    m_shownVersion = version;
+    m_shownLayout = layout;
+    m_shownCount = bars.Count();
+    m_chartDirty = false;
+    m_mappedHistoryChanged = false;
+}
+
+bool ChartPanel::OpenMappedHistory(const std::string& symbol) {
+    std::string path = ColumnarBarFile::GetPath(Config::API::BAR_STORE_DIRECTORY, symbol, "1m");
+
+    // Mapping and building its levels is only worth redoing once the file is rewritten
+    std::error_code error;
+    std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, error);
+    uintmax_t size = error ? 0 : std::filesystem::file_size(path, error);
+    if (error) {
+        size = 0;
+    }
+
+    if (path == m_mappedHistoryPath && writeTime == m_mappedHistoryTime && size == m_mappedHistorySize) {
+        return false;
+    }
+
+    // The renderer may be drawing the old mapping in place; it is refreshed before the next frame
+    if (m_mappedHistory) {
+        m_chartRenderer.ClearChartData();
+    }
+    m_mappedHistory = size > 0 ? ColumnarBarFile::Open(path) : nullptr;
+    m_mappedHistoryPath = path;
+    m_mappedHistoryTime = writeTime;
+    m_mappedHistorySize = size;
+    return true;
+}
+
+void ChartPanel::SaveMinuteHistory(const std::string& symbol) {
+    // Every candle but the last, which is still open
+    OhlcvColumns minutes = m_candles.GetCandles(InstrumentRegistry::Instance().Intern(symbol), CandleInterval::OneMinute);
+    if (minutes.count < 2) {
+        return;
+    }
+    size_t closedCount = minutes.count - 1;
+
+    // Saved bars from before the first candle are kept; the candles replace the rest
+    // (copied out, so the file is no longer mapped here when it is replaced)
+    std::string path = ColumnarBarFile::GetPath(Config::API::BAR_STORE_DIRECTORY, symbol, "1m");
+    std::shared_ptr<const ColumnarBarFile> saved = ColumnarBarFile::Open(path);
+    OhlcvColumns savedColumns = saved ? saved->GetColumns() : OhlcvColumns();
+    if (savedColumns.count > 0 &&
+        savedColumns.timestamps[savedColumns.count - 1] >= minutes.timestamps[closedCount - 1]) {
+        return;
+    }
+    size_t keepCount = std::lower_bound(savedColumns.timestamps, savedColumns.timestamps + savedColumns.count,
+        minutes.timestamps[0]) - savedColumns.timestamps;
+
+    size_t count = keepCount + closedCount;
+    std::vector<double> timestamps(savedColumns.timestamps, savedColumns.timestamps + keepCount);
+    std::vector<double> opens(savedColumns.opens, savedColumns.opens + keepCount);
+    std::vector<double> highs(savedColumns.highs, savedColumns.highs + keepCount);
+    std::vector<double> lows(savedColumns.lows, savedColumns.lows + keepCount);
+    std::vector<double> closes(savedColumns.closes, savedColumns.closes + keepCount);
+    std::vector<double> volumes(savedColumns.volumes, savedColumns.volumes + keepCount);
+    for (std::vector<double>* column : { &timestamps, &opens, &highs, &lows, &closes, &volumes }) {
+        column->reserve(count);
+    }
+    saved.reset();
+
+    timestamps.insert(timestamps.end(), minutes.timestamps, minutes.timestamps + closedCount);
+    opens.insert(opens.end(), minutes.opens, minutes.opens + closedCount);
+    highs.insert(highs.end(), minutes.highs, minutes.highs + closedCount);
+    lows.insert(lows.end(), minutes.lows, minutes.lows + closedCount);
+    closes.insert(closes.end(), minutes.closes, minutes.closes + closedCount);
+    volumes.insert(volumes.end(), minutes.volumes, minutes.volumes + closedCount);
+
+    OhlcvColumns columns;
+    columns.timestamps = timestamps.data();
+    columns.opens = opens.data();
+    columns.highs = highs.data();
+    columns.lows = lows.data();
+    columns.closes = closes.data();
+    columns.volumes = volumes.data();
+    columns.count = count;
+
+    // Windows will not replace a mapped file, so the mapping on screen is dropped for the
+    // write and the file mapped again afterwards, rewritten or not
+    bool wasMapped = m_mappedHistory && path == m_mappedHistoryPath;
+    if (wasMapped) {
+        m_chartRenderer.ClearChartData();
+        m_mappedHistory.reset();
+    }
+
+    if (!ColumnarBarFile::Write(path, columns)) {
+        m_errorMessage = "Could not save minute history for " + symbol;
+        DebugLog("Failed to save minute history for " + symbol + " to " + path + "\n");
+    }
+
+    if (wasMapped) {
+        m_mappedHistoryPath.clear();
+        OpenMappedHistory(symbol);
+        m_mappedHistoryChanged = true;
+    }
 }
 
 void ChartPanel::SetSymbol(const std::string& symbol) {
     if (m_symbol != symbol) {
         m_symbol = symbol;
+        m_instrument = InstrumentRegistry::Instance().Intern(symbol);
         m_chartRenderer.SetSymbol(symbol);
+        m_chartDirty = true;
+        m_fitHistory = true;
     }
 }
\ No newline at end of file
@@ -3,14 +3,21 @@
 #include <random>
 #include <algorithm>
 #include <cmath>
-#include <sstream>
 #include <Windows.h>
-#include <iostream>
 
 
 ChartRenderer::ChartRenderer() {
     // Generate some sample data for initial display
     GenerateSampleData();
+    OhlcvSpans sample;
+    sample.head.timestamps = m_sampleBars.timestamps.data();
+    sample.head.opens = m_sampleBars.opens.data();
+    sample.head.highs = m_sampleBars.highs.data();
+    sample.head.lows = m_sampleBars.lows.data();
+    sample.head.closes = m_sampleBars.closes.data();
+    sample.head.volumes = m_sampleBars.volumes.data();
+    sample.head.count = m_sampleBars.timestamps.size();
+    SetChartData(sample, 0);
 }
 
 ChartRenderer::~ChartRenderer() {
@@ -59,36 +66,17 @@ void ChartRenderer::SetupFinancialChartStyle() {
     style.PlotMinSize = ImVec2(300, 225);
 }
 
-void ChartRenderer::SetChartData(const std::vector<double>& timestamps,
-    const std::vector<double>& opens,
-    const std::vector<double>& highs,
-    const std::vector<double>& lows,
-    const std::vector<double>& closes,
-    const std::vector<double>& volumes) {
-    // Log what we're receiving
-    std::string debugMsg = "ChartRenderer received " + std::to_string(timestamps.size()) + " data points\n";
-
-    if (!timestamps.empty()) {
-        // Convert timestamp to readable date for debugging
-        time_t firstTime = (time_t)timestamps.front();
-        time_t lastTime = (time_t)timestamps.back();
-        char firstTimeStr[64], lastTimeStr[64];
-        strftime(firstTimeStr, sizeof(firstTimeStr), "%Y-%m-%d", localtime(&firstTime));
-        strftime(lastTimeStr, sizeof(lastTimeStr), "%Y-%m-%d", localtime(&lastTime));
-
-        debugMsg += "First point: " + std::string(firstTimeStr) + " Close: " + std::to_string(closes.front()) + "\n";
-        debugMsg += "Last point: " + std::string(lastTimeStr) + " Close: " + std::to_string(closes.back()) + "\n";
-    }
+void ChartRenderer::SetChartData(const OhlcvSpans& bars, size_t firstChanged, bool resetView) {
+    m_bars = bars;
+    m_resetView = m_resetView || resetView;
 
-    OutputDebugStringA(debugMsg.c_str());
+    // A tick changes the newest bar or adds one, which touches a bucket per level
+    m_pyramid.Update(m_bars, firstChanged);
+}
 
-    // Copy the data to our member variables
-    m_sampleTimestamps = timestamps;
-    m_sampleOpens = opens;
-    m_sampleHighs = highs;
-    m_sampleLows = lows;
-    m_sampleCloses = closes;
-    m_sampleVolumes = volumes;
+void ChartRenderer::ClearChartData() {
+    m_bars = OhlcvSpans();
+    m_pyramid.Clear();
 }
 
 void ChartRenderer::RenderCandlestickChart() {
@@ -97,49 +85,47 @@ void ChartRenderer::RenderCandlestickChart() {
 
     if (ImPlot::BeginPlot((m_symbol + "/USD").c_str(), availableSize)) {
         // Setup axes
-        ImPlot::SetupAxes("Time", "Price", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxes("Time", "Price");
         ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
         ImPlot::SetupAxisFormat(ImAxis_Y1, "$%.2f");
 
         // Skip rendering if no data
-        if (m_sampleTimestamps.empty()) {
+        if (m_bars.Count() == 0) {
             ImPlot::EndPlot();
             return;
         }
 
-        // Calculate min and max price for y-axis with proper padding
-        double min_price = *std::min_element(m_sampleLows.begin(), m_sampleLows.end());
-        double max_price = *std::max_element(m_sampleHighs.begin(), m_sampleHighs.end());
-        double price_range = max_price - min_price;
-        double padding = price_range * 0.1; // 10% padding
-
         // Set axis limits
-        ImPlot::SetupAxisLimits(ImAxis_X1, m_sampleTimestamps.front(), m_sampleTimestamps.back());
-        ImPlot::SetupAxisLimits(ImAxis_Y1, min_price - padding, max_price + padding);
+        SetupAxisLimits(false);
 
         // Define colors for up/down candles
         ImVec4 bullCol = ImVec4(0.0f, 0.8f, 0.4f, 1.0f);  // Green for up
         ImVec4 bearCol = ImVec4(0.8f, 0.0f, 0.2f, 1.0f);  // Red for down
 
+        // Zoomed out, draw merged candles from the pyramid, a few pixels apart
+        size_t first = 0;
+        size_t last = 0;
+        OhlcPyramid::Level level = SelectLevel(3.0f, first, last);
+
         // Calculate width for candlesticks
         double width = 0.6;
-        if (m_sampleTimestamps.size() > 1) {
-            width = 0.6 * (m_sampleTimestamps[1] - m_sampleTimestamps[0]);
+        if (level.barsPerBucket > 1 && level.columns.count > 1) {
+            width = 0.6 * (level.columns.timestamps[1] - level.columns.timestamps[0]);
+        }
+        else if (level.barsPerBucket == 1 && m_bars.Count() > 1) {
+            width = 0.6 * (m_bars.TimestampAt(1) - m_bars.TimestampAt(0));
         }
 
-        // Draw candlesticks
-        for (size_t i = 0; i < m_sampleTimestamps.size(); ++i) {
-            DrawCandlestick(
-                m_sampleTimestamps[i],
-                m_sampleOpens[i],
-                m_sampleCloses[i],
-                m_sampleLows[i],
-                m_sampleHighs[i],
-                bullCol,
-                bearCol,
-                width
-            );
+        // Draw candlesticks: map the bars in view to pixels in one pass, then emit them as two batches
+        if (level.barsPerBucket > 1) {
+            m_candleBatch.Build(level.columns, first, last, width, GetPlotTransform());
+        }
+        else {
+            m_candleBatch.Build(m_bars, first, last, width, GetPlotTransform());
         }
+        ImPlot::PushPlotClipRect();
+        m_candleBatch.Draw(ImPlot::GetPlotDrawList(), ImGui::GetColorU32(bullCol), ImGui::GetColorU32(bearCol));
+        ImPlot::PopPlotClipRect();
 
         ImPlot::EndPlot();
     }
@@ -151,12 +137,7 @@ void ChartRenderer::GenerateSampleData() {
     double time_now = (double)time(nullptr);
     double time_step = 24 * 60 * 60; // Daily data
 
-    m_sampleTimestamps.resize(num_points);
-    m_sampleOpens.resize(num_points);
-    m_sampleHighs.resize(num_points);
-    m_sampleLows.resize(num_points);
-    m_sampleCloses.resize(num_points);
-    m_sampleVolumes.resize(num_points);
+    SampleBars& bars = m_sampleBars;
 
     // Random generator
     std::random_device rd;
@@ -168,7 +149,7 @@ void ChartRenderer::GenerateSampleData() {
 
     for (int i = 0; i < num_points; ++i) {
         // Time data (going back in time from now)
-        m_sampleTimestamps[i] = time_now - (num_points - i) * time_step;
+        double timestamp = time_now - (num_points - i) * time_step;
 
         // Price data with a random walk
         double change = d(gen) * 2.0; // Random daily change
@@ -179,13 +160,15 @@ void ChartRenderer::GenerateSampleData() {
         double high = std::max(open, close) + std::abs(d(gen)) * 0.5;
         double low = std::min(open, close) - std::abs(d(gen)) * 0.5;
 
-        m_sampleOpens[i] = open;
-        m_sampleHighs[i] = high;
-        m_sampleLows[i] = low;
-        m_sampleCloses[i] = close;
-
         // Volume data (random, higher on big price moves)
-        m_sampleVolumes[i] = 1000000 + std::abs(change) * 200000 + d(gen) * 100000;
+        double volume = 1000000 + std::abs(change) * 200000 + d(gen) * 100000;
+
+        bars.timestamps.push_back(timestamp);
+        bars.opens.push_back(open);
+        bars.highs.push_back(high);
+        bars.lows.push_back(low);
+        bars.closes.push_back(close);
+        bars.volumes.push_back(volume);
     }
 }
 
@@ -225,46 +208,84 @@ void ChartRenderer::RenderCharts() {
     }
 }
 
-void ChartRenderer::DrawCandlestick(double x, double open, double close, double low, double high,
-    const ImVec4& bullColor, const ImVec4& bearColor, double width) {
-    // Determine if this is a bullish or bearish candle
-    bool bullish = close >= open;
-    ImU32 color = ImGui::GetColorU32(bullish ? bullColor : bearColor);
-
-    // Get the current plot
-    ImPlotContext* ctx = ImPlot::GetCurrentContext();
-    ImDrawList* draw_list = ImPlot::GetPlotDrawList();
-
-    // Convert data positions to pixel positions
-    ImVec2 lowPoint = ImPlot::PlotToPixels(x, low);
-    ImVec2 highPoint = ImPlot::PlotToPixels(x, high);
-    ImVec2 openLeft = ImPlot::PlotToPixels(x - width / 2.0, open);
-    ImVec2 openRight = ImPlot::PlotToPixels(x + width / 2.0, open);
-    ImVec2 closeLeft = ImPlot::PlotToPixels(x - width / 2.0, close);
-    ImVec2 closeRight = ImPlot::PlotToPixels(x + width / 2.0, close);
-
-    // Draw the wick (vertical line from low to high)
-    draw_list->AddLine(lowPoint, highPoint, color, 1.0f);
-
-    // Draw the body rectangle
-    if (bullish) {
-        // For bullish candles, body goes from open to close (bottom to top)
-        draw_list->AddRectFilled(
-            ImVec2(openLeft.x, openLeft.y),
-            ImVec2(closeRight.x, closeRight.y),
-            color
-        );
+OhlcPyramid::Level ChartRenderer::SelectLevel(float pixelsPerBucket, size_t& first, size_t& last) {
+    // Bars in view, with the view kept for fitting the price axis next frame
+    ImPlotRange limits = ImPlot::GetPlotLimits().X;
+    m_viewMinTime = limits.Min;
+    m_viewMaxTime = limits.Max;
+    FindBars(limits.Min, limits.Max, first, last);
+
+    double maxBuckets = std::max(1.0, static_cast<double>(ImPlot::GetPlotSize().x) / pixelsPerBucket);
+    OhlcPyramid::Level level = m_pyramid.SelectLevel(static_cast<double>(last - first), maxBuckets);
+
+    // Bucket i of a level merges bars [i * barsPerBucket, (i + 1) * barsPerBucket)
+    if (level.barsPerBucket > 1) {
+        first /= level.barsPerBucket;
+        last = std::min((last + level.barsPerBucket - 1) / level.barsPerBucket, level.columns.count);
+    }
+    return level;
+}
+
+void ChartRenderer::FindBars(double minTime, double maxTime, size_t& first, size_t& last) const {
+    // Binary search of the sorted times, in the head and then the tail. One bar of margin
+    // either side keeps candles and line segments crossing the plot edges
+    const OhlcvColumns& head = m_bars.head;
+    const OhlcvColumns& tail = m_bars.tail;
+    first = static_cast<size_t>(std::lower_bound(head.timestamps, head.timestamps + head.count, minTime) - head.timestamps);
+    if (first == head.count) {
+        first += static_cast<size_t>(std::lower_bound(tail.timestamps, tail.timestamps + tail.count, minTime) - tail.timestamps);
+    }
+    last = static_cast<size_t>(std::upper_bound(head.timestamps, head.timestamps + head.count, maxTime) - head.timestamps);
+    if (last == head.count) {
+        last += static_cast<size_t>(std::upper_bound(tail.timestamps, tail.timestamps + tail.count, maxTime) - tail.timestamps);
+    }
+    first = first > 0 ? first - 1 : 0;
+    last = std::min(last + 1, m_bars.Count());
+}
+
+void ChartRenderer::SetupAxisLimits(bool fitCloses) {
+    // Left alone, the time axis keeps wherever the user has panned or zoomed it
+    size_t first = 0;
+    size_t last = m_bars.Count();
+    if (m_resetView) {
+        ImPlot::SetupAxisLimits(ImAxis_X1, m_bars.TimestampAt(0), m_bars.TimestampAt(last - 1), ImPlotCond_Always);
+        m_resetView = false;
     }
     else {
-        // For bearish candles, body goes from close to open (bottom to top)
-        draw_list->AddRectFilled(
-            ImVec2(closeLeft.x, closeLeft.y),
-            ImVec2(openRight.x, openRight.y),
-            color
-        );
+        FindBars(m_viewMinTime, m_viewMaxTime, first, last);
+    }
+
+    // Fit the price axis to the bars in view, with 10% padding; the pyramid answers
+    // the range without visiting the bars. Nothing in view leaves the axis as it was
+    double low = 0.0;
+    double high = 0.0;
+    bool found = fitCloses ? m_pyramid.GetCloseRange(first, last, low, high)
+        : m_pyramid.GetPriceRange(first, last, low, high);
+    if (found) {
+        double padding = (high - low) * 0.1;
+        ImPlot::SetupAxisLimits(ImAxis_Y1, low - padding, high + padding, ImPlotCond_Always);
     }
 }
 
+PlotTransform ChartRenderer::GetPlotTransform() {
+    // Both axes are linear (the time scale only changes the tick labels), so two corners
+    // of the plot area fix the mapping
+    ImPlotRect limits = ImPlot::GetPlotLimits();
+    ImVec2 minPixel = ImPlot::PlotToPixels(limits.X.Min, limits.Y.Min);
+    ImVec2 maxPixel = ImPlot::PlotToPixels(limits.X.Max, limits.Y.Max);
+
+    PlotTransform transform;
+    if (limits.X.Size() > 0.0) {
+        transform.scaleX = (maxPixel.x - minPixel.x) / limits.X.Size();
+    }
+    if (limits.Y.Size() > 0.0) {
+        transform.scaleY = (maxPixel.y - minPixel.y) / limits.Y.Size();
+    }
+    transform.originX = minPixel.x - limits.X.Min * transform.scaleX;
+    transform.originY = minPixel.y - limits.Y.Min * transform.scaleY;
+    return transform;
+}
+
 // src/ChartRenderer.cpp - improved candlestick rendering
 
 
@@ -274,32 +295,73 @@ void ChartRenderer::RenderLineChart() {
 
     if (ImPlot::BeginPlot((m_symbol + "/USD").c_str(), availableSize)) {
         // Setup axes
-        ImPlot::SetupAxes("Time", "Price", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxes("Time", "Price");
         ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
         ImPlot::SetupAxisFormat(ImAxis_Y1, "$%.2f");
 
         // Skip rendering if no data
-        if (m_sampleTimestamps.empty()) {
+        if (m_bars.Count() == 0) {
             ImPlot::EndPlot();
             return;
         }
 
-        // Calculate min and max price for y-axis
-        double min_price = *std::min_element(m_sampleLows.begin(), m_sampleLows.end());
-        double max_price = *std::max_element(m_sampleHighs.begin(), m_sampleHighs.end());
-        double price_range = max_price - min_price;
-        double padding = price_range * 0.1; // 10% padding
-
         // Set axis limits
-        ImPlot::SetupAxisLimits(ImAxis_X1, m_sampleTimestamps.front(), m_sampleTimestamps.back());
-        ImPlot::SetupAxisLimits(ImAxis_Y1, min_price - padding, max_price + padding);
+        SetupAxisLimits(true);
+
+        // Draw simple line chart with closing prices in view; zoomed out, each merged
+        // bucket contributes its lowest and highest close, so spikes survive the decimation
+        size_t first = 0;
+        size_t last = 0;
+        OhlcPyramid::Level level = SelectLevel(1.0f, first, last);
+
+        const double* times = nullptr;
+        const double* closes = nullptr;
+        size_t count = last - first;
+
+        if (level.barsPerBucket == 1) {
+            // Bars in view are plotted in place, unless they run from the head into the tail
+            const OhlcvColumns& head = m_bars.head;
+            if (last <= head.count || first >= head.count) {
+                const OhlcvColumns& part = last <= head.count ? head : m_bars.tail;
+                size_t offset = last <= head.count ? 0 : head.count;
+                times = part.timestamps + (first - offset);
+                closes = part.closes + (first - offset);
+            }
+            else {
+                m_envelopeTimes.clear();
+                m_envelopeCloses.clear();
+                m_bars.ForEachPart(first, last, [this](const OhlcvColumns& part, size_t from, size_t to) {
+                    m_envelopeTimes.insert(m_envelopeTimes.end(), part.timestamps + from, part.timestamps + to);
+                    m_envelopeCloses.insert(m_envelopeCloses.end(), part.closes + from, part.closes + to);
+                });
+                times = m_envelopeTimes.data();
+                closes = m_envelopeCloses.data();
+            }
+        }
+        else {
+            const OhlcvColumns& buckets = level.columns;
+            m_envelopeTimes.resize(count * 2);
+            m_envelopeCloses.resize(count * 2);
+            for (size_t i = 0; i < count; i++) {
+                // Visit the extremes in the order the closes reached them
+                size_t bucket = first + i;
+                bool minFirst = level.closeMinFirst[bucket] != 0;
+                m_envelopeTimes[2 * i] = buckets.timestamps[bucket];
+                m_envelopeTimes[2 * i + 1] = buckets.timestamps[bucket];
+                m_envelopeCloses[2 * i] = minFirst ? level.closeMins[bucket] : level.closeMaxs[bucket];
+                m_envelopeCloses[2 * i + 1] = minFirst ? level.closeMaxs[bucket] : level.closeMins[bucket];
+            }
+
+            times = m_envelopeTimes.data();
+            closes = m_envelopeCloses.data();
+            count = m_envelopeTimes.size();
+        }
 
-        // Draw simple line chart with closing prices
         ImPlot::SetNextLineStyle(ImVec4(0.0f, 0.8f, 1.0f, 1.0f), 2.0f);
         ImPlot::PlotLine("Price",
-            m_sampleTimestamps.data(),
-            m_sampleCloses.data(),
-            (int)m_sampleCloses.size());
+            times,
+            closes,
+            (int)count);
 
         ImPlot::EndPlot();
     }
@@ -0,0 +1,71 @@
+#include "CircuitBreaker.h"
+#include <algorithm>
+
+CircuitBreaker::CircuitBreaker(int failureThreshold, Clock::duration openDuration, Clock::duration maxOpenDuration)
+    : m_failureThreshold(std::max(1, failureThreshold)),
+      m_baseOpenDuration(openDuration),
+      m_maxOpenDuration(std::max(openDuration, maxOpenDuration)),
+      m_openDuration(openDuration) {
+}
+
+CircuitBreaker::Admission CircuitBreaker::Admit(Clock::time_point now, Clock::duration& retryAfter) {
+    if (now < m_pausedUntil) {
+        retryAfter = m_pausedUntil - now;
+        return Admission::Wait;
+    }
+
+    switch (m_state) {
+    case State::Closed:
+        return Admission::Allow;
+
+    case State::Open:
+        if (now < m_openUntil) {
+            return Admission::Reject;
+        }
+        // The open period is over; hand out the probe
+        m_state = State::HalfOpen;
+        m_probeInFlight = false;
+        [[fallthrough]];
+
+    case State::HalfOpen:
+        if (m_probeInFlight) {
+            return Admission::Reject;
+        }
+        m_probeInFlight = true;
+        return Admission::Allow;
+    }
+
+    return Admission::Allow;
+}
+
+void CircuitBreaker::ReleaseProbe() {
+    m_probeInFlight = false;
+}
+
+void CircuitBreaker::RecordSuccess() {
+    m_state = State::Closed;
+    m_consecutiveFailures = 0;
+    m_openDuration = m_baseOpenDuration;
+    m_probeInFlight = false;
+}
+
+void CircuitBreaker::RecordFailure(Clock::time_point now) {
+    m_consecutiveFailures++;
+
+    if (m_state == State::HalfOpen) {
+        // The probe failed: stay away for longer this time
+        m_openDuration = std::min(m_openDuration * 2, m_maxOpenDuration);
+        m_state = State::Open;
+        m_openUntil = now + m_openDuration;
+    }
+    else if (m_state == State::Closed && m_consecutiveFailures >= m_failureThreshold) {
+        m_state = State::Open;
+        m_openUntil = now + m_openDuration;
+    }
+
+    m_probeInFlight = false;
+}
+
+void CircuitBreaker::PauseUntil(Clock::time_point until) {
+    m_pausedUntil = std::max(m_pausedUntil, until);
+}
@@ -0,0 +1,205 @@
+#include "ColumnarBarFile.h"
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char FILE_MAGIC[4] = { 'D', 'T', 'C', 'B' };
+    const uint32_t FILE_VERSION = 2;
+    const size_t COLUMN_COUNT = 6;
+
+    // Columns start 8-byte aligned straight after the header
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t reserved[2];
+        uint64_t count;
+    };
+
+    static_assert(sizeof(FileHeader) == 24, "unexpected columnar file header layout");
+
+    // Columns are stored as the host's doubles, which must therefore be little-endian
+    bool IsLittleEndian() {
+        const uint32_t probe = 1;
+        unsigned char first;
+        std::memcpy(&first, &probe, 1);
+        return first == 1;
+    }
+
+    size_t FileSize(uint64_t count) {
+        return sizeof(FileHeader) + static_cast<size_t>(count) * COLUMN_COUNT * sizeof(double);
+    }
+}
+
+ColumnarBarFile::~ColumnarBarFile() {
+    Unmap();
+}
+
+std::shared_ptr<const ColumnarBarFile> ColumnarBarFile::Open(const std::string& path) {
+    std::shared_ptr<ColumnarBarFile> file(new ColumnarBarFile());
+    if (!file->Map(path)) {
+        return nullptr;
+    }
+    return file;
+}
+
+std::string ColumnarBarFile::GetPath(const std::string& directory, const std::string& symbol,
+    const std::string& interval) {
+    // Keep the file name to characters that are safe on every filesystem
+    std::string name;
+    for (char c : symbol + "_" + interval) {
+        name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    return (std::filesystem::path(directory) / (name + ".ohlcv")).string();
+}
+
+bool ColumnarBarFile::Map(const std::string& path) {
+    if (!IsLittleEndian()) {
+        return false;
+    }
+
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(FileHeader))) {
+        Unmap();
+        return false;
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        Unmap();
+        return false;
+    }
+
+    m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+        close(fd);
+        return false;
+    }
+    m_size = static_cast<size_t>(info.st_size);
+
+    // The mapping stays valid after the descriptor is closed
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    m_data = data == MAP_FAILED ? nullptr : static_cast<const unsigned char*>(data);
+#endif
+
+    if (!m_data) {
+        Unmap();
+        return false;
+    }
+
+    // Check the header against the file before trusting any offsets
+    FileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION ||
+        header.count > m_size || FileSize(header.count) != m_size) {
+        Unmap();
+        return false;
+    }
+
+    size_t count = static_cast<size_t>(header.count);
+    const double* columns = reinterpret_cast<const double*>(m_data + sizeof(FileHeader));
+    m_columns.timestamps = columns;
+    m_columns.opens = columns + count;
+    m_columns.highs = columns + 2 * count;
+    m_columns.lows = columns + 3 * count;
+    m_columns.closes = columns + 4 * count;
+    m_columns.volumes = columns + 5 * count;
+    m_columns.count = count;
+
+    return true;
+}
+
+void ColumnarBarFile::Unmap() {
+#ifdef _WIN32
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+    }
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data) {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_columns = OhlcvColumns();
+}
+
+bool ColumnarBarFile::Write(const std::string& path, const OhlcvColumns& columns) {
+    if (!IsLittleEndian()) {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        FileHeader header = {};
+        std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = FILE_VERSION;
+        header.count = columns.count;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::streamsize columnBytes = static_cast<std::streamsize>(columns.count * sizeof(double));
+        for (const double* column : { columns.timestamps, columns.opens, columns.highs,
+            columns.lows, columns.closes, columns.volumes }) {
+            file.write(reinterpret_cast<const char*>(column), columnBytes);
+        }
+
+        if (!file.flush()) {
+            return false;
+        }
+    }
+
+    // Fails on Windows while the old file is mapped; the temporary file is not left behind
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
@@ -1,5 +1,6 @@
 #include "Config.h"
-#include <Windows.h>  // For OutputDebugStringA
+#include "DebugLog.h"
+#include <algorithm>
 #include <fstream>
 #include <nlohmann/json.hpp>
 
@@ -9,11 +10,38 @@ namespace Config {
         // Make this a variable (not const) so it can be loaded from config
         std::string CMC_API_KEY = "9d71734b-d6d6-44e0-8487-fbabf2c392d6";
 
+        // Overridable from config so the client can run against a local stand-in
+        std::string CMC_BASE_URL = "https://pro-api.coinmarketcap.com";
+
+        // Relative to the working directory unless set in config
+        std::string BAR_STORE_DIRECTORY = "cache";
+
+        // No push feed unless one is configured
+        std::string FEED_URL;
+        int MAX_CONCURRENT_REQUESTS = 6;
+        int WORKER_THREADS = 8;
+
+        // Plan limits; overridable from config to match the account's plan
+        int REQUESTS_PER_MINUTE = 30;
+        int CREDITS_PER_MINUTE = 2000;
+        int CREDITS_PER_DAY = 3333;
+
         // These remain constants
-        const std::string CMC_BASE_URL = "https://pro-api.coinmarketcap.com";
         const int REQUEST_TIMEOUT = 10;
         const float PRICE_UPDATE_INTERVAL = 15.0f;
         const float CHART_UPDATE_INTERVAL = 60.0f;
+        const int HISTORICAL_DAYS = 30;
+        const int MAX_HTTP_CONNECTIONS = 8;
+        const int HTTP_IDLE_TIMEOUT = 60;
+        const float BACKGROUND_BUDGET_RESERVE = 0.25f;
+        const int CIRCUIT_FAILURE_THRESHOLD = 5;
+        const int CIRCUIT_OPEN_SECONDS = 30;
+        const int CIRCUIT_MAX_OPEN_SECONDS = 300;
+        const int QUOTE_CACHE_TTL = 60;
+        const int HISTORICAL_CACHE_TTL = 24 * 60 * 60;
+        const int RESPONSE_CACHE_MAX_MB = 256;
+        const int FEED_TIMEOUT_SECONDS = 10;
+        const int FEED_RECONNECT_MAX_SECONDS = 30;
     }
 
     // UI Settings - Make sure these are all defined
@@ -27,6 +55,9 @@ namespace Config {
         // Available cryptocurrencies
         const std::string AVAILABLE_CRYPTOS[] = { "BTC", "ETH", "USDT", "SOL", "XRP", "BNB", "ADA", "DOT" };
         const int AVAILABLE_CRYPTOS_COUNT = sizeof(AVAILABLE_CRYPTOS) / sizeof(AVAILABLE_CRYPTOS[0]);
+
+        // Candles kept per symbol for each chart interval (a day of minute bars)
+        const int CANDLE_CAPACITY = 1440;
     }
 
     // Application settings
@@ -48,17 +79,53 @@ namespace Config {
                     API::CMC_API_KEY = config["api"]["coinmarketcap_key"];
                 }
 
+                // Optional endpoint override (e.g. a local HTTP stand-in for testing)
+                if (config.contains("api") && config["api"].contains("base_url")) {
+                    API::CMC_BASE_URL = config["api"]["base_url"];
+                }
+
+                // Optional location of the on-disk bar store
+                if (config.contains("api") && config["api"].contains("cache_dir")) {
+                    API::BAR_STORE_DIRECTORY = config["api"]["cache_dir"];
+                }
+
+                // Optional WebSocket price feed
+                if (config.contains("api") && config["api"].contains("feed_url")) {
+                    API::FEED_URL = config["api"]["feed_url"];
+                }
+
+                // Optional limit on concurrent requests to any one endpoint
+                if (config.contains("api") && config["api"].contains("max_concurrent_requests")) {
+                    API::MAX_CONCURRENT_REQUESTS = std::max(1, config["api"]["max_concurrent_requests"].get<int>());
+                }
+
+                // Optional size of the request worker pool
+                if (config.contains("api") && config["api"].contains("worker_threads")) {
+                    API::WORKER_THREADS = std::max(1, config["api"]["worker_threads"].get<int>());
+                }
+
+                // Optional rate and credit limits of the API plan
+                if (config.contains("api") && config["api"].contains("requests_per_minute")) {
+                    API::REQUESTS_PER_MINUTE = std::max(1, config["api"]["requests_per_minute"].get<int>());
+                }
+                if (config.contains("api") && config["api"].contains("credits_per_minute")) {
+                    API::CREDITS_PER_MINUTE = std::max(1, config["api"]["credits_per_minute"].get<int>());
+                }
+                if (config.contains("api") && config["api"].contains("credits_per_day")) {
+                    API::CREDITS_PER_DAY = std::max(1, config["api"]["credits_per_day"].get<int>());
+                }
+
                 configFile.close();
             }
             else {
                 // Log warning about missing config
-                OutputDebugStringA("Warning: config.json not found, using defaults\n");
+                DebugLog("Warning: config.json not found, using defaults\n");
             }
         }
         catch (const std::exception& e) {
             // Log error
             std::string error = "Error loading config: " + std::string(e.what()) + "\n";
-            OutputDebugStringA(error.c_str());
+            DebugLog(error);
         }
     }
 }
\ No newline at end of file
@@ -1,8 +1,11 @@
 #include "CryptoAPIClient.h"
 #include "Config.h"
-#include "SimpleHttpClient.h"
-#include <nlohmann/json.hpp>
+#include "DebugLog.h"
+#include "QuoteExtractor.h"
 #include <iostream>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
 #include <sstream>
 #include <ctime>
 #include <random>
@@ -10,8 +13,82 @@
 #include <chrono>
 #include <unordered_map>
 
+// Interval of the bars kept in the bar store
+static const char* const DAILY_INTERVAL = "1d";
+
+// API credits charged for a request: quotes cost one credit per 100 symbols and
+// listings one per 100 rows returned, rounded up
+static double EstimateCredits(const std::string& endpoint, const std::map<std::string, std::string>& params) {
+    size_t units = 1;
+    size_t unitsPerCredit = 1;
+
+    if (endpoint.find("/quotes/") != std::string::npos) {
+        auto symbols = params.find("symbol");
+        if (symbols != params.end()) {
+            units = std::count(symbols->second.begin(), symbols->second.end(), ',') + 1;
+        }
+        unitsPerCredit = 100;
+    }
+    else if (endpoint.find("/listings/") != std::string::npos) {
+        auto limit = params.find("limit");
+        units = limit != params.end() ? std::strtoul(limit->second.c_str(), nullptr, 10) : 100;
+        unitsPerCredit = 100;
+    }
+
+    return static_cast<double>(std::max<size_t>(1, (units + unitsPerCredit - 1) / unitsPerCredit));
+}
+
+// How hard to retry an endpoint. Quotes are polled again on the next refresh anyway,
+// while a historical day is fetched once and worth waiting for
+struct RetryPolicy {
+    int maxRetries;
+    double baseDelaySeconds;
+    double maxDelaySeconds;
+};
+
+static RetryPolicy GetRetryPolicy(const std::string& endpoint) {
+    if (endpoint.find("/quotes/") != std::string::npos) {
+        return { 2, 1.0, 8.0 };
+    }
+    if (endpoint.find("/listings/historical") != std::string::npos) {
+        return { 4, 2.0, 60.0 };
+    }
+    return { 3, 1.0, 30.0 };
+}
+
+// Exponential backoff with jitter: half the delay is fixed and half random, so
+// clients that failed together do not retry in lockstep
+static RateLimiter::Clock::duration RetryDelay(const RetryPolicy& policy, int attempt) {
+    thread_local std::mt19937 rng(std::random_device{}());
+    std::uniform_real_distribution<double> jitter(0.5, 1.0);
+
+    double delay = std::min(policy.maxDelaySeconds, policy.baseDelaySeconds * std::pow(2.0, attempt));
+    return std::chrono::duration_cast<RateLimiter::Clock::duration>(
+        std::chrono::duration<double>(delay * jitter(rng)));
+}
+
+// How long a response stays fresh: quotes for as long as CoinMarketCap takes to
+// refresh them, historical snapshots (always of past days) for a day. Zero means
+// the endpoint is not cached
+static ResponseCache::Clock::duration GetCacheTtl(const std::string& endpoint) {
+    if (endpoint.find("/quotes/") != std::string::npos) {
+        return std::chrono::seconds(Config::API::QUOTE_CACHE_TTL);
+    }
+    if (endpoint.find("/listings/historical") != std::string::npos) {
+        return std::chrono::seconds(Config::API::HISTORICAL_CACHE_TTL);
+    }
+    return ResponseCache::Clock::duration::zero();
+}
+
+// Server-side trouble worth retrying: no response, rate limited, or a 5xx other than 501
+static bool IsRetryable(bool responded, int statusCode) {
+    return !responded || statusCode == 429 || (statusCode >= 500 && statusCode != 501);
+}
+
 // Implementation using WinHttp for real API calls
-CryptoAPIClient::CryptoAPIClient() : m_shouldStop(false) {
+CryptoAPIClient::CryptoAPIClient()
+    : m_responseCache(static_cast<size_t>(Config::API::RESPONSE_CACHE_MAX_MB) * 1024 * 1024),
+      m_shouldStop(false) {
 }
 
 CryptoAPIClient::~CryptoAPIClient() {
@@ -22,129 +99,377 @@ bool CryptoAPIClient::Initialize(const std::string& apiKey) {
     m_apiKey = apiKey;
     m_baseUrl = Config::API::CMC_BASE_URL;
 
+    // Pooled keep-alive transport reused for the lifetime of the client
+    if (!m_transport) {
+        m_transport = CreateHttpTransport(
+            Config::API::MAX_HTTP_CONNECTIONS,
+            Config::API::HTTP_IDLE_TIMEOUT,
+            Config::API::REQUEST_TIMEOUT);
+    }
+
+    // Bars saved by earlier runs
+    if (!m_barStore) {
+        m_barStore = std::make_unique<BarStore>(Config::API::BAR_STORE_DIRECTORY);
+    }
+
     // Start the request processing thread
-    m_shouldStop = false;
-    m_requestThread = std::make_unique<std::thread>(&CryptoAPIClient::ProcessRequests, this);
+    StartRequestThread();
 
     return true;
 }
 
 void CryptoAPIClient::Shutdown() {
-    if (m_requestThread) {
-        // Signal the thread to stop
-        m_shouldStop = true;
-        m_queueCondition.notify_one();
+    // Requests queued or handed to the workers but not started
+    std::vector<APIRequest> abandoned;
+
+    {
+        std::lock_guard<std::mutex> threadLock(m_threadMutex);
+
+        if (m_requestThread) {
+            // Signal the dispatcher and the workers to stop
+            {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                m_shouldStop = true;
+            }
+            m_wakeCondition.notify_one();
+
+            {
+                std::lock_guard<std::mutex> lock(m_readyMutex);
+            }
+            m_readyCondition.notify_all();
+
+            // Wait for the threads to finish; requests already running complete first
+            if (m_requestThread->joinable()) {
+                m_requestThread->join();
+            }
+            m_requestThread.reset();
+
+            for (auto& worker : m_workers) {
+                worker.join();
+            }
+            m_workers.clear();
+
+            APIRequest request;
+            while (PopRequest(request)) {
+                abandoned.push_back(std::move(request));
+            }
+            for (auto& queue : m_readyRequests) {
+                for (auto& ready : queue) {
+                    abandoned.push_back(std::move(ready));
+                }
+                queue.clear();
+            }
+            m_activeRequests.clear();
+            m_threadRunning = false;
+        }
+    }
+
+    // Fail them so no caller is left waiting; callbacks run without the thread lock
+    for (auto& request : abandoned) {
+        FailRequest(request);
+    }
+
+    // Callers still attached to an entry (e.g. to a history load that never started)
+    // are failed too; otherwise requests made after a restart would coalesce onto
+    // entries that can no longer complete
+    std::unordered_map<std::string, InFlightRequest> inFlight;
+    {
+        std::lock_guard<std::mutex> lock(m_inFlightMutex);
+        inFlight.swap(m_inFlight);
+    }
+
+    for (auto& entry : inFlight) {
+        *entry.second.cancelled = true;
+        for (const auto& callback : entry.second.callbacks) {
+            callback({});
+        }
 
-        // Wait for the thread to finish
-        if (m_requestThread->joinable()) {
-            m_requestThread->join();
+        std::shared_ptr<const BarSeries> empty =
+            std::make_shared<BarSeries>(InstrumentRegistry::Instance().GetSymbol(entry.second.instrument));
+        for (const auto& historyCallback : entry.second.historyCallbacks) {
+            historyCallback(empty, true);
         }
-        m_requestThread.reset();
     }
 }
 
-bool CryptoAPIClient::FetchLatestQuote(const std::string& symbol,
-    std::function<void(const PriceData&, bool)> callback) {
+bool CryptoAPIClient::FetchLatestQuote(const std::string& symbol, QuoteCallback callback,
+    RequestPriority priority) {
+    return FetchLatestQuotes({ symbol }, std::move(callback), priority);
+}
+
+bool CryptoAPIClient::FetchLatestQuotes(const std::vector<std::string>& symbols, QuoteCallback callback,
+    RequestPriority priority) {
+    if (symbols.empty()) {
+        return true;
+    }
+
     // Skip if no API key configured
     if (m_apiKey.empty()) {
-        m_lastError = "API key not configured";
-        callback(GenerateMockPriceData(symbol), false);
+        SetError("API key not configured");
+        for (const auto& symbol : symbols) {
+            callback(GenerateMockPriceData(symbol), false);
+        }
         return false;
     }
 
+    // One request covers every symbol
+    std::string symbolList;
+    for (const auto& symbol : symbols) {
+        if (!symbolList.empty()) {
+            symbolList += ",";
+        }
+        symbolList += symbol;
+    }
+
     // Set up endpoint and parameters
-    std::string endpoint = "/v1/cryptocurrency/quotes/latest";
-    std::map<std::string, std::string> params = {
-        {"symbol", symbol},
+    APIRequest request;
+    request.endpoint = "/v1/cryptocurrency/quotes/latest";
+    request.params = {
+        {"symbol", symbolList},
         {"convert", "USD"}
     };
+    request.priority = priority;
+
+    // Intern once per request rather than per quote delivered
+    std::vector<InstrumentId> instruments;
+    instruments.reserve(symbols.size());
+    for (const auto& symbol : symbols) {
+        instruments.push_back(InstrumentRegistry::Instance().Intern(symbol));
+    }
+
+    auto onResponse = [this, symbols, instruments, callback](std::string_view response) {
+        // Stream the response, keeping only the requested quotes
+        QuoteExtractionResult result;
+        bool parsed = QuoteExtractor::Extract(response, symbols, result);
 
-    // Queue the request with retry and timeout handling
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-    m_requestQueue.push_back({
-        endpoint,
-        params,
-        [this, symbol, callback](const std::string& response) {
-            try {
-                // Parse JSON response
-                auto json = nlohmann::json::parse(response);
-
-                // Error handling - check API errors
-                if (json.contains("status") && json["status"].contains("error_code") &&
-                    json["status"]["error_code"] != 0) {
-
-                    m_lastError = "API Error: " + json["status"]["error_message"].get<std::string>();
-                    callback(GenerateMockPriceData(symbol), false);
-                    return;
+        if (!parsed) {
+            SetError("Error parsing quotes response");
+        }
+        else if (result.errorCode != 0) {
+            // Error handling - check API errors
+            SetError("API Error: " + result.errorMessage);
+        }
+
+        // Fan the results out per symbol, falling back to mock data for anything missing
+        for (size_t i = 0; i < symbols.size(); i++) {
+            const std::string& symbol = symbols[i];
+            auto it = parsed && result.errorCode == 0 ? result.quotes.find(symbol) : result.quotes.end();
+            if (it == result.quotes.end()) {
+                if (parsed && result.errorCode == 0) {
+                    SetError("API response missing required data fields for " + symbol);
                 }
+                callback(GenerateMockPriceData(symbol), false);
+                continue;
+            }
+
+            // Extract price data
+            const ExtractedQuote& quote = it->second;
+            PriceData data;
+            data.symbol = symbol;
+            data.instrument = instruments[i];
+            data.price = quote.price;
+            data.volume24h = quote.volume24h;
+            data.percentChange1h = quote.percentChange1h;
+            data.percentChange24h = quote.percentChange24h;
+            data.percentChange7d = quote.percentChange7d;
+            data.marketCap = quote.marketCap;
+            data.lastUpdated = quote.lastUpdated;
+
+            callback(data, true);
+        }
+    };
 
-                // Extract price data
-                PriceData data;
-                data.symbol = symbol;
+    // Queue the request unless an identical one is already queued or in flight, in which
+    // case the callback rides along with it. Single-symbol requests can be cancelled
+    std::string key = MakeRequestKey(request.endpoint, request.params);
+    InstrumentId cancelInstrument = symbols.size() == 1 ? instruments.front() : INVALID_INSTRUMENT;
+    if (RegisterRequest(request, key, cancelInstrument, std::move(onResponse), nullptr)) {
+        EnqueueRequest(std::move(request));
+    }
+
+    return true;
+}
 
-                // Extract all the relevant fields, with error checking
-                if (json["data"].contains(symbol) &&
-                    json["data"][symbol].contains("quote") &&
-                    json["data"][symbol]["quote"].contains("USD")) {
+void CryptoAPIClient::EnqueueRequest(APIRequest request) {
+    if (!request.task) {
+        request.cacheKey = MakeRequestKey(request.endpoint, request.params);
+        request.credits = EstimateCredits(request.endpoint, request.params);
+    }
 
-                    auto& usdData = json["data"][symbol]["quote"]["USD"];
+    size_t queue = static_cast<size_t>(request.priority);
+    m_requestQueues[queue].Push(std::move(request));
 
-                    data.price = usdData.contains("price") ? usdData["price"].get<double>() : 0.0;
-                    data.volume24h = usdData.contains("volume_24h") ? usdData["volume_24h"].get<double>() : 0.0;
-                    data.percentChange1h = usdData.contains("percent_change_1h") ?
-                                         usdData["percent_change_1h"].get<double>() : 0.0;
-                    data.percentChange24h = usdData.contains("percent_change_24h") ?
-                                          usdData["percent_change_24h"].get<double>() : 0.0;
-                    data.lastUpdated = json["data"][symbol].contains("last_updated") ?
-                                     json["data"][symbol]["last_updated"].get<std::string>() : "";
+    // Start processing thread if needed
+    if (!m_threadRunning) {
+        StartRequestThread();
+    }
 
-                    callback(data, true);
-                }
- else {
-  m_lastError = "API response missing required data fields";
-  callback(GenerateMockPriceData(symbol), false);
+    // Only take the lock when the dispatcher is (about to be) asleep
+    if (m_consumerWaiting) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.notify_one();
+    }
 }
+
+void CryptoAPIClient::StartRequestThread() {
+    std::lock_guard<std::mutex> lock(m_threadMutex);
+    if (m_threadRunning) {
+        return;
+    }
+
+    m_shouldStop = false;
+
+    if (!m_rateLimiter) {
+        m_rateLimiter = std::make_unique<RateLimiter>(
+            Config::API::REQUESTS_PER_MINUTE,
+            Config::API::CREDITS_PER_MINUTE,
+            Config::API::CREDITS_PER_DAY,
+            Config::API::BACKGROUND_BUDGET_RESERVE);
+    }
+
+    // Keep one worker clear of any single endpoint so a burst of slow requests
+    // (e.g. a chart's listings) never holds up the quotes
+    int workerCount = std::max(1, Config::API::WORKER_THREADS);
+    m_endpointLimit = std::max(1, std::min(Config::API::MAX_CONCURRENT_REQUESTS, workerCount - 1));
+
+    m_requestThread = std::make_unique<std::thread>(&CryptoAPIClient::ProcessRequests, this);
+    for (int i = 0; i < workerCount; i++) {
+        m_workers.emplace_back(&CryptoAPIClient::WorkerLoop, this);
+    }
+    m_threadRunning = true;
 }
-catch (const std::exception& e) {
-    m_lastError = "Error parsing response: " + std::string(e.what());
-    callback(GenerateMockPriceData(symbol), false);
+
+std::string CryptoAPIClient::MakeRequestKey(const std::string& endpoint,
+    const std::map<std::string, std::string>& params) {
+    // Parameters come out of the map sorted, so equal requests give equal keys
+    std::string key = endpoint;
+    for (const auto& param : params) {
+        key += (key.size() == endpoint.size() ? "?" : "&") + param.first + "=" + param.second;
+    }
+    return key;
 }
+
+bool CryptoAPIClient::RegisterRequest(APIRequest& request, const std::string& key, InstrumentId instrument,
+    ResponseCallback callback, HistoricalCallback historyCallback) {
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+
+    auto it = m_inFlight.find(key);
+    bool isNew = it == m_inFlight.end();
+    if (isNew) {
+        it = m_inFlight.emplace(key, InFlightRequest()).first;
+        it->second.instrument = instrument;
+        it->second.cancelled = std::make_shared<std::atomic<bool>>(false);
+    }
+
+    if (callback) {
+        it->second.callbacks.push_back(std::move(callback));
+    }
+    if (historyCallback) {
+        it->second.historyCallbacks.push_back(std::move(historyCallback));
+    }
+
+    request.key = key;
+    request.cancelled = it->second.cancelled;
+    return isNew;
 }
-        });
 
-    // Start processing thread if needed
-    if (!m_requestThread || !m_requestThread->joinable()) {
-        m_shouldStop = false;
-        m_requestThread = std::make_unique<std::thread>(&CryptoAPIClient::ProcessRequests, this);
+std::vector<CryptoAPIClient::ResponseCallback> CryptoAPIClient::TakeCallbacks(const APIRequest& request) {
+    if (request.key.empty()) {
+        return {};
     }
 
-    m_queueCondition.notify_one();
-    return true;
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+
+    // The entry may have been cancelled (and even replaced by a newer request) meanwhile
+    auto it = m_inFlight.find(request.key);
+    if (it == m_inFlight.end() || it->second.cancelled != request.cancelled) {
+        return {};
+    }
+
+    std::vector<ResponseCallback> callbacks = std::move(it->second.callbacks);
+    m_inFlight.erase(it);
+    return callbacks;
 }
 
-// Cache for mock price data to ensure consistency
-static std::unordered_map<std::string, PriceData> mockPriceCache;
+void CryptoAPIClient::FailRequest(APIRequest& request) {
+    if (request.callback) {
+        request.callback({});
+    }
+    for (const auto& callback : TakeCallbacks(request)) {
+        callback({});
+    }
+}
+
+size_t CryptoAPIClient::CancelRequestsFor(InstrumentId instrument) {
+    if (instrument == INVALID_INSTRUMENT) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(m_inFlightMutex);
+
+    size_t cancelled = 0;
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end();) {
+        if (it->second.instrument == instrument) {
+            *it->second.cancelled = true;
+            it = m_inFlight.erase(it);
+            cancelled++;
+        }
+        else {
+            ++it;
+        }
+    }
+    return cancelled;
+}
+
+bool CryptoAPIClient::PopRequest(APIRequest& request) {
+    // Highest priority class first
+    for (auto& queue : m_requestQueues) {
+        if (queue.TryPop(request)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CryptoAPIClient::RequestsPending() const {
+    for (const auto& queue : m_requestQueues) {
+        if (!queue.Empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Cache for mock price data to ensure consistency, indexed by instrument; quotes fall
+// back to mock data from the workers and the UI thread alike
+static std::vector<PriceData> mockPriceCache;
+static std::mutex mockPriceMutex;
 
 PriceData CryptoAPIClient::GenerateMockPriceData(const std::string& symbol) {
+    InstrumentId instrument = InstrumentRegistry::Instance().Intern(symbol);
+    std::lock_guard<std::mutex> lock(mockPriceMutex);
+
     // Check if we already have mock data for this symbol
-    if (mockPriceCache.count(symbol) > 0) {
+    if (instrument < mockPriceCache.size() && mockPriceCache[instrument].instrument == instrument) {
+        PriceData& cached = mockPriceCache[instrument];
+
         // Update the timestamp
         time_t now = time(nullptr);
         char timeBuffer[30];
         strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%dT%H:%M:%S.000Z", gmtime(&now));
-        mockPriceCache[symbol].lastUpdated = timeBuffer;
+        cached.lastUpdated = timeBuffer;
 
         // Add a small random variance to the price (0.5%) to simulate market movement
         double variance = (rand() % 100 - 50) * 0.0001; // -0.5% to +0.5%
-        mockPriceCache[symbol].price *= (1.0 + variance);
+        cached.price *= (1.0 + variance);
 
         // Update OHLC data
-        mockPriceCache[symbol].open = mockPriceCache[symbol].price;
-        mockPriceCache[symbol].high = mockPriceCache[symbol].price * 1.005;
-        mockPriceCache[symbol].low = mockPriceCache[symbol].price * 0.995;
-        mockPriceCache[symbol].close = mockPriceCache[symbol].price;
+        cached.open = cached.price;
+        cached.high = cached.price * 1.005;
+        cached.low = cached.price * 0.995;
+        cached.close = cached.price;
 
-        return mockPriceCache[symbol];
+        return cached;
     }
 
     // Use a fixed seed based on the symbol to ensure consistency
@@ -154,6 +479,7 @@ PriceData CryptoAPIClient::GenerateMockPriceData(const std::string& symbol) {
 
     PriceData mockData;
     mockData.symbol = symbol;
+    mockData.instrument = instrument;
 
     if (symbol == "BTC") {
         mockData.price = 65000.0 + (std::rand() % 2000 - 1000);
@@ -201,180 +527,283 @@ PriceData CryptoAPIClient::GenerateMockPriceData(const std::string& symbol) {
     mockData.close = mockData.price;
 
     // Cache the mock data
-    mockPriceCache[symbol] = mockData;
+    if (instrument >= mockPriceCache.size()) {
+        mockPriceCache.resize(instrument + 1);
+    }
+    mockPriceCache[instrument] = mockData;
 
     return mockData;
 }
 
-// Cache for historical data to ensure consistency
-static std::unordered_map<std::string, std::vector<PriceData>> historicalDataCache;
-
-bool CryptoAPIClient::FetchHistoricalData(const std::string& symbol,
-    std::function<void(const std::vector<PriceData>&)> callback) {
+bool CryptoAPIClient::FetchHistoricalData(const std::string& symbol, HistoricalCallback callback,
+    RequestPriority priority) {
     if (m_apiKey.empty()) {
-        m_lastError = "API key not configured";
-        callback(std::vector<PriceData>());
+        SetError("API key not configured");
+        callback(std::make_shared<BarSeries>(symbol), true);
         return false;
     }
 
-    // We'll use the listings/historical endpoint which is available in your API tier
-    std::string endpoint = "/v1/cryptocurrency/listings/historical";
+    // A load already queued or running for this symbol picks up the extra callback
+    APIRequest request;
+    request.priority = priority;
 
-    // Create a vector to store historical data points
-    std::vector<PriceData> historicalData;
+    std::string key = "history:" + symbol;
+    if (!RegisterRequest(request, key, InstrumentRegistry::Instance().Intern(symbol), nullptr, std::move(callback))) {
+        return true;
+    }
 
-    // We need to fetch multiple days to build chart data
-    // Let's get data for the last 30 days
-    time_t now = time(nullptr);
+    // Progress goes to every caller registered against the load, unless it has been cancelled
+    std::shared_ptr<std::atomic<bool>> cancelled = request.cancelled;
+    HistoricalCallback deliver = [this, key, cancelled](const std::shared_ptr<const BarSeries>& series, bool isComplete) {
+        std::vector<HistoricalCallback> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(m_inFlightMutex);
+            auto it = m_inFlight.find(key);
+            if (it == m_inFlight.end() || it->second.cancelled != cancelled) {
+                return;
+            }
 
-    // Process one day at a time to build the chart data
-    auto processDayData = [this, &historicalData, symbol, callback, now](int daysAgo) {
-        // Calculate date
-        time_t dayTime = now - (daysAgo * 24 * 60 * 60);
-        char dateStr[11]; // YYYY-MM-DD
-        strftime(dateStr, sizeof(dateStr), "%Y-%m-%d", gmtime(&dayTime));
-
-        // Parameters for this specific day
-        std::map<std::string, std::string> params = {
-            {"date", dateStr},
-            {"limit", "5000"},  // High limit to ensure we get all cryptos
-            {"convert", "USD"}
-        };
+            if (isComplete) {
+                callbacks = std::move(it->second.historyCallbacks);
+                m_inFlight.erase(it);
+            }
+            else {
+                callbacks = it->second.historyCallbacks;
+            }
+        }
 
-        // Make the API request for this day
-        std::string response;
-        if (!MakeRequest("/v1/cryptocurrency/listings/historical", params, response)) {
-            OutputDebugStringA(("Failed to get data for " + std::string(dateStr) + "\n").c_str());
-            return false;
+        for (const auto& historyCallback : callbacks) {
+            historyCallback(series, isComplete);
         }
+        };
 
-        try {
-            // Parse the response
-            auto json = nlohmann::json::parse(response);
+    // Planning the load runs on a worker; its requests then go through the queues like any other
+    request.task = [this, symbol, deliver, cancelled, priority]() {
+        LoadHistoricalData(symbol, deliver, cancelled, priority);
+    };
+    EnqueueRequest(std::move(request));
 
-            // Check for API errors
-            if (json.contains("status") && json["status"].contains("error_code") &&
-                json["status"]["error_code"] != 0) {
+    return true;
+}
 
-                m_lastError = "API Error: " + json["status"]["error_message"].get<std::string>();
-                OutputDebugStringA(m_lastError.c_str());
-                return false;
-            }
+void CryptoAPIClient::LoadHistoricalData(const std::string& symbol, HistoricalCallback callback,
+    const std::shared_ptr<std::atomic<bool>>& cancelled, RequestPriority priority) {
+    const time_t daySeconds = 24 * 60 * 60;
 
-            // Find the specific crypto in the data array
-            bool found = false;
-            if (json.contains("data") && json["data"].is_array()) {
-                for (const auto& crypto : json["data"]) {
-                    if (crypto.contains("symbol") && crypto["symbol"] == symbol) {
-                        // Found our cryptocurrency
-                        PriceData data;
-                        data.symbol = symbol;
-                        data.timestamp = dayTime;
+    // Bars are keyed by the UTC midnight that starts their day; today's bar is still open
+    time_t now = time(nullptr);
+    time_t today = now - (now % daySeconds);
+    time_t windowStart = today - Config::API::HISTORICAL_DAYS * daySeconds;
 
-                        // Get price data
-                        if (crypto.contains("quote") && crypto["quote"].contains("USD")) {
-                            data.close = crypto["quote"]["USD"]["price"].get<double>();
-                            data.volume = crypto["quote"]["USD"]["volume_24h"].get<double>();
+    auto load = std::make_shared<HistoricalLoad>();
+    load->symbol = symbol;
+    load->today = today;
+    load->callback = std::move(callback);
 
-                            // For OHLC, we only have close price, so approximate others
-                            double priceChange = crypto["quote"]["USD"]["percent_change_24h"].get<double>() / 100.0;
-                            data.open = data.close / (1.0 + priceChange);
+    std::vector<APIRequest> jobs;
 
-                            // Approximate high/low based on daily volatility
-                            double volatility = std::abs(priceChange) * 1.5;
-                            data.high = data.close * (1.0 + volatility / 2);
-                            data.low = data.close * (1.0 - volatility / 2);
+    RestoreHistory(symbol, windowStart);
 
-                            historicalData.push_back(data);
-                            found = true;
-                            break;
-                        }
-                    }
-                }
-            }
+    {
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        SymbolHistory& history = m_historyCache[symbol];
+
+        // Drop days that have scrolled out of the window
+        history.settledDays.erase(history.settledDays.begin(), history.settledDays.lower_bound(windowStart));
+        history.unavailableDays.erase(history.unavailableDays.begin(), history.unavailableDays.lower_bound(windowStart));
+
+        load->merged.insert(history.settledDays.begin(), history.settledDays.end());
 
-            if (!found) {
-                OutputDebugStringA(("Symbol " + symbol + " not found for " + std::string(dateStr) + "\n").c_str());
+        // Only days we have never settled need a listings/historical snapshot
+        for (time_t dayTime = windowStart; dayTime < today; dayTime += daySeconds) {
+            if (history.settledDays.count(dayTime) > 0 || history.unavailableDays.count(dayTime) > 0) {
+                continue;
             }
 
-            return found;
-        }
-        catch (const std::exception& e) {
-            m_lastError = "Error parsing data for " + std::string(dateStr) + ": " + std::string(e.what());
-            OutputDebugStringA(m_lastError.c_str());
-            return false;
+            char dateStr[11]; // YYYY-MM-DD
+            strftime(dateStr, sizeof(dateStr), "%Y-%m-%d", gmtime(&dayTime));
+
+            APIRequest job;
+            job.endpoint = "/v1/cryptocurrency/listings/historical";
+            job.params = { {"date", dateStr}, {"limit", "5000"}, {"convert", "USD"} };
+            job.callback = [this, load, dayTime, label = std::string(dateStr)](std::string_view response) {
+                OnHistoricalResult(*load, static_cast<double>(dayTime), label, response);
+            };
+            jobs.push_back(std::move(job));
         }
-        };
+    }
 
-    // Start with latest data using listings/latest for most accurate current price
-    std::map<std::string, std::string> latestParams = {
-        {"limit", "5000"},
-        {"convert", "USD"}
+    // The open bar always comes from a single-symbol quote rather than the full listings
+    APIRequest latest;
+    latest.endpoint = "/v1/cryptocurrency/quotes/latest";
+    latest.params = { {"symbol", symbol}, {"convert", "USD"} };
+    latest.callback = [this, load, today](std::string_view response) {
+        OnHistoricalResult(*load, static_cast<double>(today), "latest", response);
     };
+    jobs.push_back(std::move(latest));
 
-    std::string latestResponse;
-    if (MakeRequest("/v1/cryptocurrency/listings/latest", latestParams, latestResponse)) {
-        try {
-            auto json = nlohmann::json::parse(latestResponse);
-
-            // Find the current price
-            if (json.contains("data") && json["data"].is_array()) {
-                for (const auto& crypto : json["data"]) {
-                    if (crypto.contains("symbol") && crypto["symbol"] == symbol) {
-                        PriceData data;
-                        data.symbol = symbol;
-                        data.timestamp = now;
-
-                        if (crypto.contains("quote") && crypto["quote"].contains("USD")) {
-                            data.close = crypto["quote"]["USD"]["price"].get<double>();
-                            data.volume = crypto["quote"]["USD"]["volume_24h"].get<double>();
-
-                            // For OHLC, we only have close price, so approximate others
-                            double priceChange = crypto["quote"]["USD"]["percent_change_24h"].get<double>() / 100.0;
-                            data.open = data.close / (1.0 + priceChange);
-
-                            // Approximate high/low based on daily volatility
-                            double volatility = std::abs(priceChange) * 1.5;
-                            data.high = data.close * (1.0 + volatility / 2);
-                            data.low = data.close * (1.0 - volatility / 2);
-
-                            historicalData.push_back(data);
-                            break;
-                        }
-                    }
-                }
+    DebugLog("Fetching " + std::to_string(jobs.size()) + " of " +
+        std::to_string(Config::API::HISTORICAL_DAYS + 1) + " bars for " + symbol + "\n");
+
+    {
+        std::lock_guard<std::mutex> lock(load->mutex);
+        load->remaining = jobs.size();
+
+        // Show the cached days straight away
+        if (!load->merged.empty()) {
+            load->callback(load->Snapshot(), false);
+        }
+    }
+
+    // The per-endpoint cap keeps the listings requests from crowding out other work
+    for (auto& job : jobs) {
+        job.priority = priority;
+        job.cancelled = cancelled;
+        EnqueueRequest(std::move(job));
+    }
+}
+
+void CryptoAPIClient::RestoreHistory(const std::string& symbol, time_t windowStart) {
+    {
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        SymbolHistory& history = m_historyCache[symbol];
+        if (history.restored) {
+            return;
+        }
+        history.restored = true;
+    }
+
+    // Read the file outside the lock; loads of other symbols carry on meanwhile
+    std::vector<BarStore::Bar> bars;
+    if (!m_barStore || !m_barStore->Load(symbol, DAILY_INTERVAL, windowStart, bars)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_historyMutex);
+    SymbolHistory& history = m_historyCache[symbol];
+    for (const auto& bar : bars) {
+        time_t dayTime = static_cast<time_t>(bar.timestamp);
+        if (bar.unavailable) {
+            history.unavailableDays.insert(dayTime);
+        }
+        else {
+            history.settledDays.emplace(dayTime, bar);
+        }
+    }
+
+    DebugLog("Restored " + std::to_string(bars.size()) + " stored bars for " + symbol + "\n");
+}
+
+void CryptoAPIClient::OnHistoricalResult(HistoricalLoad& load, double timestamp, const std::string& label,
+    std::string_view response) {
+    PriceData data;
+    ParseResult result = ParseResult::Error;
+
+    if (response.empty()) {
+        DebugLog("Failed to get data for " + label + "\n");
+    }
+    else {
+        result = ParseSymbolEntry(response, load.symbol, timestamp, data);
+        if (result == ParseResult::Missing) {
+            DebugLog("Symbol " + load.symbol + " not found for " + label + "\n");
+        }
+        else if (result == ParseResult::Error) {
+            DebugLog("Error parsing data for " + label + ": " + GetLastError() + "\n");
+        }
+    }
+
+    time_t dayTime = static_cast<time_t>(timestamp);
+    BarStore::Bar bar;
+    bar.timestamp = static_cast<int64_t>(dayTime);
+    if (result == ParseResult::Found) {
+        bar.open = data.open;
+        bar.high = data.high;
+        bar.low = data.low;
+        bar.close = data.close;
+        bar.volume = data.volume;
+    }
+
+    // Past days can no longer change, so remember them, here and on disk
+    if (dayTime < load.today && result != ParseResult::Error) {
+        {
+            std::lock_guard<std::mutex> lock(m_historyMutex);
+            SymbolHistory& history = m_historyCache[load.symbol];
+            if (result == ParseResult::Found) {
+                history.settledDays[dayTime] = bar;
+            }
+            else {
+                history.unavailableDays.insert(dayTime);
+                bar.unavailable = true;
             }
         }
-        catch (const std::exception& e) {
-            OutputDebugStringA(("Error parsing latest data: " + std::string(e.what()) + "\n").c_str());
+
+        if (m_barStore && !m_barStore->Append(load.symbol, DAILY_INTERVAL, { bar })) {
+            DebugLog("Failed to store the bar for " + label + "\n");
         }
     }
 
-    // Now get historical data for previous days
-    for (int day = 1; day <= 30; day++) {
-        processDayData(day);
+    // Merge results in timestamp order as they arrive and hand out the partial series
+    std::lock_guard<std::mutex> lock(load.mutex);
+    if (result == ParseResult::Found) {
+        load.merged[dayTime] = bar;
+    }
+
+    if (--load.remaining > 0) {
+        if (result == ParseResult::Found) {
+            load.callback(load.Snapshot(), false);
+        }
+        return;
     }
 
-    // Sort by timestamp (oldest to newest)
-    std::sort(historicalData.begin(), historicalData.end(),
-        [](const PriceData& a, const PriceData& b) {
-            return a.timestamp < b.timestamp;
-        });
+    std::shared_ptr<const BarSeries> historicalData = load.Snapshot();
 
     // Log what we found
-    OutputDebugStringA(("Retrieved " + std::to_string(historicalData.size()) +
-        " data points for " + symbol + "\n").c_str());
+    DebugLog("Retrieved " + std::to_string(historicalData->Size()) +
+        " data points for " + load.symbol + "\n");
 
-    if (!historicalData.empty()) {
-        callback(historicalData);
-        return true;
+    load.callback(historicalData, true);
+}
+
+CryptoAPIClient::ParseResult CryptoAPIClient::ParseSymbolEntry(std::string_view response,
+    const std::string& symbol, double timestamp, PriceData& data) {
+    // Stream through the (up to 5000 row) response, keeping only this symbol
+    QuoteExtractionResult result;
+    if (!QuoteExtractor::Extract(response, { symbol }, result)) {
+        SetError("Malformed JSON response");
+        return ParseResult::Error;
     }
 
-    callback(std::vector<PriceData>());
-    return false;
+    // Check for API errors
+    if (result.errorCode != 0) {
+        SetError("API Error: " + result.errorMessage);
+        return ParseResult::Error;
+    }
+
+    auto it = result.quotes.find(symbol);
+    if (it == result.quotes.end()) {
+        return ParseResult::Missing;
+    }
+
+    const ExtractedQuote& quote = it->second;
+
+    data.symbol = symbol;
+    data.timestamp = timestamp;
+    data.close = quote.price;
+    data.volume = quote.volume24h;
+
+    // For OHLC, we only have close price, so approximate others
+    double priceChange = quote.percentChange24h / 100.0;
+    data.open = data.close / (1.0 + priceChange);
+
+    // Approximate high/low based on daily volatility
+    double volatility = std::abs(priceChange) * 1.5;
+    data.high = data.close * (1.0 + volatility / 2);
+    data.low = data.close * (1.0 - volatility / 2);
+
+    return ParseResult::Found;
 }
 
-void CryptoAPIClient::GenerateMockHistoricalData(const std::string& symbol, std::vector<PriceData>& data, int numDays) {
+void CryptoAPIClient::GenerateMockHistoricalData(const std::string& symbol, BarSeries& series, int numDays) {
     // Use a fixed seed based on the symbol to ensure consistency
     std::hash<std::string> hasher;
     size_t hash = hasher(symbol);
@@ -412,7 +841,9 @@ void CryptoAPIClient::GenerateMockHistoricalData(const std::string& symbol, std:
     }
 
     // Generate data for the past numDays days
-    data.resize(numDays);
+    series.SetSymbol(symbol);
+    series.Clear();
+    series.Reserve(numDays);
 
     // We'll use a simple random walk to generate price movements
     double price = basePrice;
@@ -435,21 +866,28 @@ void CryptoAPIClient::GenerateMockHistoricalData(const std::string& symbol, std:
         double low = std::min(open, close) * (1.0 - (std::rand() % 50) * 0.0001);  // Up to 0.5% lower
 
         // Create the data point
-        PriceData& point = data[i];
-        point.symbol = symbol;
-        point.timestamp = timestamp;
-        point.open = open;
-        point.high = high;
-        point.low = low;
-        point.close = close;
-        point.volume = basePrice * (std::rand() % 1000 + 500) * 10.0; // Random volume
-
-        // Also set the price fields for convenience
-        point.price = close;
+        double volume = basePrice * (std::rand() % 1000 + 500) * 10.0; // Random volume
+        series.Append(static_cast<int64_t>(timestamp), open, high, low, close, volume);
     }
 }
 
-bool CryptoAPIClient::MakeRequest(const std::string& endpoint, const std::map<std::string, std::string>& params, std::string& response) {
+bool CryptoAPIClient::MakeRequest(const std::string& endpoint, const std::map<std::string, std::string>& params,
+    const std::string& cacheKey, ResponseBufferPool::Buffer& response, RequestOutcome& outcome) {
+    // Fresh responses are served from memory without a round trip
+    ResponseCache::Clock::duration ttl = GetCacheTtl(endpoint);
+    if (ttl > ResponseCache::Clock::duration::zero()) {
+        outcome.cachedBody = m_responseCache.Lookup(cacheKey);
+        if (outcome.cachedBody) {
+            outcome.fromCache = true;
+            return true;
+        }
+    }
+
+    if (!m_transport) {
+        SetError("HTTP transport not initialized");
+        return false;
+    }
+
     try {
         // Build the URL with query parameters
         std::string url = m_baseUrl + endpoint + "?";
@@ -472,59 +910,412 @@ bool CryptoAPIClient::MakeRequest(const std::string& endpoint, const std::map<st
             {"Accept", "application/json"}
         };
 
-        // Make the HTTP request
+        // Revalidate an expired entry instead of downloading it again, if the server gave validators
+        ResponseCache::Validators validators;
+        if (ttl > ResponseCache::Clock::duration::zero() && m_responseCache.GetValidators(cacheKey, validators)) {
+            if (!validators.etag.empty()) {
+                headers["If-None-Match"] = validators.etag;
+            }
+            if (!validators.lastModified.empty()) {
+                headers["If-Modified-Since"] = validators.lastModified;
+            }
+        }
+
+        // Make the HTTP request, reading the body into a pooled buffer for this endpoint
+        response = m_responseBuffers.Acquire(endpoint);
+        m_requestsSent++;
+
         std::string error;
-        bool success = SimpleHttpClient::Get(url, headers, response, error);
+        HttpResponse httpResponse;
+        httpResponse.body.swap(response.Data());
+        bool success = m_transport->Get(url, headers, httpResponse, error);
+        httpResponse.body.swap(response.Data());
+
+        // Report what the server said, for the retry policy and circuit breaker
+        outcome.responded = success;
+        outcome.statusCode = httpResponse.statusCode;
+        auto retryAfter = httpResponse.headers.find("retry-after");
+        if (retryAfter != httpResponse.headers.end() && !retryAfter->second.empty() &&
+            std::isdigit(static_cast<unsigned char>(retryAfter->second[0]))) {
+            outcome.retryAfterSeconds = std::atoi(retryAfter->second.c_str());
+        }
+
+        // Not modified: the cached body is still current
+        if (success && httpResponse.statusCode == 304) {
+            outcome.cachedBody = m_responseCache.Revalidate(cacheKey, ttl);
+            if (outcome.cachedBody) {
+                std::cout << "API response not modified, using cached copy (" << outcome.cachedBody->size()
+                    << " bytes)" << std::endl;
+                return true;
+            }
+            error = "Response not modified, but the cached copy has been evicted";
+            success = false;
+        }
+        else if (success && httpResponse.statusCode != 200) {
+            error = "HTTP error: " + std::to_string(httpResponse.statusCode);
+            success = false;
+        }
+
+        // A body shorter than announced must not be parsed, let alone cached for a day
+        auto contentLength = httpResponse.headers.find("content-length");
+        if (success && contentLength != httpResponse.headers.end() &&
+            std::strtoull(contentLength->second.c_str(), nullptr, 10) != response.View().size()) {
+            error = "Truncated response body";
+            outcome.responded = false;
+            success = false;
+        }
 
         if (!success) {
-            m_lastError = "HTTP request failed: " + error;
-            std::cerr << m_lastError << std::endl;
+            SetError("HTTP request failed: " + error);
+            std::cerr << "HTTP request failed: " << error << std::endl;
             return false;
         }
 
         // Log successful response (partial, for debugging)
-        if (response.length() > 0) {
-            std::cout << "Received API response (" << response.length()
-                << " bytes): " << response.substr(0, 100) << "..." << std::endl;
+        if (!response.View().empty()) {
+            std::cout << "Received API response (" << response.View().size()
+                << " bytes): " << response.View().substr(0, 100) << "..." << std::endl;
+        }
+
+        // Keep it for the endpoint's TTL, with any validators for revalidating it later. The
+        // cache gets a copy sized to the body; the pooled buffer keeps its capacity for the
+        // endpoint's next response
+        if (ttl > ResponseCache::Clock::duration::zero()) {
+            ResponseCache::Validators received;
+            auto etag = httpResponse.headers.find("etag");
+            if (etag != httpResponse.headers.end()) {
+                received.etag = etag->second;
+            }
+            auto lastModified = httpResponse.headers.find("last-modified");
+            if (lastModified != httpResponse.headers.end()) {
+                received.lastModified = lastModified->second;
+            }
+            outcome.cachedBody = m_responseCache.Store(cacheKey, std::string(response.View()), std::move(received), ttl);
         }
 
         return true;
     }
     catch (const std::exception& e) {
-        m_lastError = "Request error: " + std::string(e.what());
-        std::cerr << m_lastError << std::endl;
+        SetError("Request error: " + std::string(e.what()));
+        std::cerr << "Request error: " << e.what() << std::endl;
         return false;
     }
 }
 
+APIMetrics CryptoAPIClient::GetMetrics() const {
+    APIMetrics metrics;
+    if (m_rateLimiter) {
+        RateLimiterStats stats = m_rateLimiter->GetStats();
+        metrics.requestsAvailable = stats.requestsAvailable;
+        metrics.creditsAvailable = stats.creditsAvailable;
+        metrics.creditsUsedToday = stats.creditsUsedToday;
+        metrics.creditsRemainingToday = stats.creditsRemainingToday;
+    }
+
+    metrics.requestsSent = m_requestsSent;
+    metrics.requestsDeferred = m_requestsDeferred;
+    metrics.requestsRejected = m_requestsRejected;
+    metrics.requestsRetried = m_requestsRetried;
+    metrics.requestsShortCircuited = m_requestsShortCircuited;
+
+    ResponseCache::Stats cacheStats = m_responseCache.GetStats();
+    metrics.cacheHits = cacheStats.hits;
+    metrics.cacheMisses = cacheStats.misses;
+    metrics.cacheRevalidated = cacheStats.revalidated;
+    metrics.cacheBytes = cacheStats.bytes;
+
+    std::lock_guard<std::mutex> lock(m_breakerMutex);
+    for (const auto& entry : m_breakers) {
+        if (entry.second.GetState() != CircuitBreaker::State::Closed) {
+            metrics.openCircuits++;
+        }
+    }
+    return metrics;
+}
+
+std::string CryptoAPIClient::GetLastError() const {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    return m_lastError;
+}
+
+void CryptoAPIClient::SetError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    m_lastError = error;
+}
+
 void CryptoAPIClient::ProcessRequests() {
     while (!m_shouldStop) {
         APIRequest request;
 
-        // Wait for a request
+        // Wait for a request; the thread only sleeps when every queue is empty
+        if (!PopRequest(request)) {
+            if (RequestsPending()) {
+                // A producer is part-way through a push
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_consumerWaiting = true;
+            m_wakeCondition.wait(lock, [this] { return m_shouldStop || RequestsPending(); });
+            m_consumerWaiting = false;
+            continue;
+        }
+
+        // Hand everything that is queued to the workers in one go
+        {
+            std::lock_guard<std::mutex> lock(m_readyMutex);
+            do {
+                size_t queue = static_cast<size_t>(request.priority);
+                m_readyRequests[queue].push_back(std::move(request));
+            } while (PopRequest(request));
+        }
+        m_readyCondition.notify_all();
+    }
+}
+
+void CryptoAPIClient::WorkerLoop() {
+    while (true) {
+        APIRequest request;
+
         {
-            std::unique_lock<std::mutex> lock(m_queueMutex);
-            m_queueCondition.wait(lock, [this] { return m_shouldStop || !m_requestQueue.empty(); });
+            std::unique_lock<std::mutex> lock(m_readyMutex);
+            while (!m_shouldStop) {
+                auto retryAfter = RateLimiter::Clock::duration::max();
+                if (TakeRunnable(request, retryAfter)) {
+                    break;
+                }
 
-            if (m_shouldStop && m_requestQueue.empty()) {
+                // Sleep until woken, or until the rate limiter has budget again
+                if (retryAfter == RateLimiter::Clock::duration::max()) {
+                    m_readyCondition.wait(lock);
+                }
+                else {
+                    m_readyCondition.wait_for(lock, retryAfter);
+                }
+            }
+            if (m_shouldStop) {
                 break;
             }
+        }
+
+        bool retry = ExecuteRequest(request);
+
+        // Free the endpoint slot; a request held back by the cap may now run
+        {
+            std::lock_guard<std::mutex> lock(m_readyMutex);
+            if (!request.endpoint.empty()) {
+                m_activeRequests[request.endpoint]--;
+            }
 
-            if (!m_requestQueue.empty()) {
-                request = m_requestQueue.front();
-                m_requestQueue.erase(m_requestQueue.begin());
+            // Failed requests wait out their backoff in the ready list
+            if (retry) {
+                size_t queue = static_cast<size_t>(request.priority);
+                m_readyRequests[queue].push_back(std::move(request));
             }
         }
+        m_readyCondition.notify_all();
+    }
+}
+
+bool CryptoAPIClient::TakeRunnable(APIRequest& request, RateLimiter::Clock::duration& retryAfter) {
+    // Once one request waits for budget, later ones may not overtake it and spend the tokens
+    bool budgetBlocked = false;
+    RateLimiter::Clock::time_point now = RateLimiter::Clock::now();
+
+    // Highest priority first, oldest first within a priority, skipping endpoints at their cap
+    for (auto& queue : m_readyRequests) {
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (!it->endpoint.empty() && m_activeRequests[it->endpoint] >= m_endpointLimit) {
+                continue;
+            }
+
+            // Retries sit out their backoff
+            if (it->notBefore > now) {
+                retryAfter = std::min(retryAfter, it->notBefore - now);
+                continue;
+            }
+
+            // Requests the cache can answer go straight through
+            if (!it->task && !it->fromCache && m_responseCache.IsFresh(it->cacheKey)) {
+                it->fromCache = true;
+            }
+
+            // Tasks, cached or cancelled requests and ones already refused need no budget
+            bool needsBudget = !it->task && !it->fromCache && !it->overBudget && !it->circuitOpen &&
+                !(it->cancelled && *it->cancelled);
+            if (needsBudget && budgetBlocked) {
+                continue;
+            }
+
+            if (needsBudget) {
+                // The endpoint's circuit breaker goes first, so a request that fails fast costs no budget
+                std::lock_guard<std::mutex> breakerLock(m_breakerMutex);
+                CircuitBreaker& breaker = GetBreaker(it->endpoint);
+
+                RateLimiter::Clock::duration wait;
+                switch (breaker.Admit(now, wait)) {
+                case CircuitBreaker::Admission::Wait:
+                    retryAfter = std::min(retryAfter, wait);
+                    continue;
+                case CircuitBreaker::Admission::Reject:
+                    it->circuitOpen = true;
+                    break;
+                case CircuitBreaker::Admission::Allow:
+                    it->probe = breaker.GetState() == CircuitBreaker::State::HalfOpen;
+                    break;
+                }
+
+                RateLimiter::Decision decision = RateLimiter::Decision::Granted;
+                if (!it->circuitOpen && m_rateLimiter) {
+                    decision = m_rateLimiter->TryAcquire(it->credits, it->priority == RequestPriority::Background, wait);
+                }
+
+                // A half-open probe that is not sent goes back for the next request
+                if (decision != RateLimiter::Decision::Granted && it->probe) {
+                    breaker.ReleaseProbe();
+                    it->probe = false;
+                }
+
+                if (decision == RateLimiter::Decision::Wait) {
+                    if (!it->deferred) {
+                        it->deferred = true;
+                        m_requestsDeferred++;
+                    }
+                    retryAfter = std::min(retryAfter, wait);
+                    budgetBlocked = true;
+                    continue;
+                }
+                if (decision == RateLimiter::Decision::Exhausted) {
+                    it->overBudget = true;
+                }
+                it->admitted = !it->circuitOpen && !it->overBudget;
+            }
 
-        // Process the request
-        std::string response;
-        if (MakeRequest(request.endpoint, request.params, response)) {
-            // Call the callback with the response
-            request.callback(response);
+            if (!it->endpoint.empty()) {
+                m_activeRequests[it->endpoint]++;
+            }
+            request = std::move(*it);
+            queue.erase(it);
+            return true;
         }
-        else {
-            // Call the callback with an empty response to trigger fallback
-            request.callback("");
+    }
+    return false;
+}
+
+CircuitBreaker& CryptoAPIClient::GetBreaker(const std::string& endpoint) {
+    auto it = m_breakers.find(endpoint);
+    if (it == m_breakers.end()) {
+        it = m_breakers.emplace(endpoint, CircuitBreaker(
+            Config::API::CIRCUIT_FAILURE_THRESHOLD,
+            std::chrono::seconds(Config::API::CIRCUIT_OPEN_SECONDS),
+            std::chrono::seconds(Config::API::CIRCUIT_MAX_OPEN_SECONDS))).first;
+    }
+    return it->second;
+}
+
+void CryptoAPIClient::ReturnAdmission(APIRequest& request) {
+    if (!request.admitted) {
+        return;
+    }
+    request.admitted = false;
+
+    // A half-open breaker would otherwise wait forever for the probe's outcome
+    if (request.probe) {
+        request.probe = false;
+        std::lock_guard<std::mutex> lock(m_breakerMutex);
+        CircuitBreaker& breaker = GetBreaker(request.endpoint);
+        if (breaker.GetState() == CircuitBreaker::State::HalfOpen) {
+            breaker.ReleaseProbe();
         }
     }
+
+    if (m_rateLimiter) {
+        m_rateLimiter->Refund(request.credits);
+    }
+}
+
+bool CryptoAPIClient::ExecuteRequest(APIRequest& request) {
+    // Drop requests for symbols the user has moved away from
+    if (request.cancelled && *request.cancelled) {
+        ReturnAdmission(request);
+        if (request.callback) {
+            request.callback({});
+        }
+        return false;
+    }
+
+    // Background tasks do their own requests
+    if (request.task) {
+        request.task();
+        return false;
+    }
+
+    // Process the request, unless the daily credits are spent or the endpoint is failing
+    ResponseBufferPool::Buffer response;
+    RequestOutcome outcome;
+    bool success = false;
+    if (request.overBudget) {
+        SetError("API credit budget for today is exhausted");
+        m_requestsRejected++;
+    }
+    else if (request.circuitOpen) {
+        SetError("Requests to " + request.endpoint + " suspended after repeated failures");
+        m_requestsShortCircuited++;
+    }
+    else {
+        success = MakeRequest(request.endpoint, request.params, request.cacheKey, response, outcome);
+
+        // Another worker may have cached the response since this one was admitted
+        if (outcome.fromCache) {
+            ReturnAdmission(request);
+        }
+        request.admitted = false;
+        request.probe = false;
+        bool serverFailure = !success && IsRetryable(outcome.responded, outcome.statusCode);
+
+        RateLimiter::Clock::time_point now = RateLimiter::Clock::now();
+        if (!outcome.fromCache) {
+            std::lock_guard<std::mutex> lock(m_breakerMutex);
+            CircuitBreaker& breaker = GetBreaker(request.endpoint);
+
+            // Client errors (bad key, bad parameters) say nothing about the server's health
+            if (serverFailure) {
+                breaker.RecordFailure(now);
+            }
+            else {
+                breaker.RecordSuccess();
+            }
+
+            // Retry-After holds back every request to the endpoint, not just this one
+            if (outcome.retryAfterSeconds >= 0) {
+                breaker.PauseUntil(now + std::chrono::seconds(outcome.retryAfterSeconds));
+            }
+        }
+
+        // Back off and try again, unless the caller has gone away in the meantime
+        RetryPolicy policy = GetRetryPolicy(request.endpoint);
+        if (serverFailure && request.attempt < policy.maxRetries && !(request.cancelled && *request.cancelled)) {
+            request.notBefore = now + (outcome.retryAfterSeconds >= 0 ?
+                std::chrono::duration_cast<RateLimiter::Clock::duration>(std::chrono::seconds(outcome.retryAfterSeconds)) :
+                RetryDelay(policy, request.attempt));
+            request.attempt++;
+            m_requestsRetried++;
+            return true;
+        }
+    }
+    std::string_view body;
+    if (success) {
+        body = outcome.cachedBody ? std::string_view(*outcome.cachedBody) : response.View();
+    }
+
+    // Hand the one response to every caller that attached to it; an empty
+    // response triggers their fallback
+    if (request.callback) {
+        request.callback(body);
+    }
+    for (const auto& callback : TakeCallbacks(request)) {
+        callback(body);
+    }
+    return false;
 }
\ No newline at end of file
@@ -0,0 +1,16 @@
+#include "HttpTransport.h"
+
+#ifdef _WIN32
+#include "SimpleHttpClient.h"
+#else
+#include "PosixHttpTransport.h"
+#endif
+
+std::unique_ptr<IHttpTransport> CreateHttpTransport(size_t maxConnections, int idleTimeoutSeconds,
+    int requestTimeoutSeconds) {
+#ifdef _WIN32
+    return std::make_unique<SimpleHttpClient>(maxConnections, idleTimeoutSeconds, requestTimeoutSeconds);
+#else
+    return std::make_unique<PosixHttpTransport>(maxConnections, idleTimeoutSeconds, requestTimeoutSeconds);
+#endif
+}
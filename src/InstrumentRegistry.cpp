@@ -0,0 +1,47 @@
+#include "InstrumentRegistry.h"
+#include <mutex>
+
+InstrumentRegistry& InstrumentRegistry::Instance() {
+    static InstrumentRegistry registry;
+    return registry;
+}
+
+InstrumentId InstrumentRegistry::Intern(const std::string& symbol) {
+    // Almost every call is for a symbol seen before
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_ids.find(symbol);
+        if (it != m_ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_ids.find(symbol);
+    if (it != m_ids.end()) {
+        return it->second;
+    }
+
+    InstrumentId id = static_cast<InstrumentId>(m_symbols.size());
+    m_symbols.push_back(symbol);
+    m_ids.emplace(symbol, id);
+    return id;
+}
+
+InstrumentId InstrumentRegistry::Find(const std::string& symbol) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_ids.find(symbol);
+    return it == m_ids.end() ? INVALID_INSTRUMENT : it->second;
+}
+
+const std::string& InstrumentRegistry::GetSymbol(InstrumentId id) const {
+    static const std::string unknown;
+
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return id < m_symbols.size() ? m_symbols[id] : unknown;
+}
+
+size_t InstrumentRegistry::Size() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_symbols.size();
+}
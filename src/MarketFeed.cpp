@@ -0,0 +1,207 @@
+#include "MarketFeed.h"
+#include "Config.h"
+#include "DebugLog.h"
+#include <algorithm>
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+MarketFeed::MarketFeed(std::string url)
+    : m_url(std::move(url)) {
+}
+
+MarketFeed::~MarketFeed() {
+    Stop();
+}
+
+void MarketFeed::Start(TickCallback callback) {
+    if (m_thread) {
+        return;
+    }
+
+    m_callback = std::move(callback);
+    m_shouldStop = false;
+    m_thread = std::make_unique<std::thread>(&MarketFeed::Run, this);
+}
+
+void MarketFeed::Stop() {
+    if (!m_thread) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_shouldStop = true;
+    }
+    m_stopCondition.notify_all();
+
+    // Unblock a receive in progress
+    {
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        if (m_connection) {
+            m_connection->Abort();
+        }
+    }
+
+    if (m_thread->joinable()) {
+        m_thread->join();
+    }
+    m_thread.reset();
+    m_live = false;
+}
+
+void MarketFeed::SetSymbols(const std::vector<std::string>& symbols) {
+    std::vector<std::string> sorted = symbols;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    std::lock_guard<std::mutex> lock(m_symbolsMutex);
+    if (sorted != m_symbols) {
+        m_symbols = std::move(sorted);
+        m_symbolsChanged = true;
+    }
+}
+
+MarketFeedStats MarketFeed::GetStats() const {
+    MarketFeedStats stats;
+    stats.live = m_live;
+    stats.ticks = m_ticks;
+    stats.gaps = m_gaps;
+    stats.reconnects = m_reconnects;
+    return stats;
+}
+
+void MarketFeed::Run() {
+    int backoffSeconds = 1;
+
+    while (!m_shouldStop) {
+        std::unique_ptr<IWebSocketConnection> connection = CreateWebSocketConnection();
+        std::string error;
+        bool connected = connection->Connect(m_url, Config::API::FEED_TIMEOUT_SECONDS, error);
+
+        if (connected) {
+            // Register the connection so Stop() can abort it; it may already have been called
+            {
+                std::lock_guard<std::mutex> lock(m_connectionMutex);
+                m_connection = connection.get();
+            }
+
+            if (!m_shouldStop) {
+                DebugLog("Market feed connected to " + m_url + "\n");
+                backoffSeconds = 1;
+                RunConnection(*connection);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_connectionMutex);
+                m_connection = nullptr;
+            }
+        }
+        else {
+            DebugLog("Market feed connection failed: " + error + "\n");
+        }
+
+        // Quotes fall back to REST polling until the feed is back
+        m_live = false;
+        if (m_shouldStop) {
+            break;
+        }
+
+        // Reconnect after a backoff, doubling while the server stays away
+        std::unique_lock<std::mutex> lock(m_stopMutex);
+        m_stopCondition.wait_for(lock, std::chrono::seconds(backoffSeconds), [this] { return m_shouldStop.load(); });
+        backoffSeconds = std::min(backoffSeconds * 2, Config::API::FEED_RECONNECT_MAX_SECONDS);
+        m_reconnects++;
+    }
+}
+
+void MarketFeed::RunConnection(IWebSocketConnection& connection) {
+    std::string error;
+    if (!Subscribe(connection, error)) {
+        DebugLog("Market feed subscribe failed: " + error + "\n");
+        return;
+    }
+
+    uint64_t lastSequence = 0;
+    std::string message;
+    while (!m_shouldStop && connection.Receive(message, error)) {
+        bool resubscribe = !HandleMessage(message, lastSequence);
+
+        // Pick up symbol changes, and recover from lost messages with fresh snapshots
+        {
+            std::lock_guard<std::mutex> lock(m_symbolsMutex);
+            resubscribe = resubscribe || m_symbolsChanged;
+        }
+        if (resubscribe && !Subscribe(connection, error)) {
+            break;
+        }
+    }
+
+    if (!m_shouldStop) {
+        DebugLog("Market feed disconnected: " + error + "\n");
+    }
+}
+
+bool MarketFeed::Subscribe(IWebSocketConnection& connection, std::string& error) {
+    nlohmann::json request;
+    {
+        std::lock_guard<std::mutex> lock(m_symbolsMutex);
+        request["op"] = "subscribe";
+        request["symbols"] = m_symbols;
+        m_symbolsChanged = false;
+    }
+    return connection.Send(request.dump(), error);
+}
+
+bool MarketFeed::HandleMessage(const std::string& message, uint64_t& lastSequence) {
+    nlohmann::json parsed = nlohmann::json::parse(message, nullptr, false);
+    if (parsed.is_discarded() || !parsed.is_object()) {
+        DebugLog("Market feed sent malformed message\n");
+        return true;
+    }
+
+    // Fields of the wrong type are treated like a malformed message
+    bool inSequence = true;
+    try {
+        // Messages older than one already seen are dropped; a jump means some were lost
+        uint64_t sequence = parsed.value("seq", static_cast<uint64_t>(0));
+        if (sequence != 0) {
+            if (lastSequence != 0 && sequence <= lastSequence) {
+                return true;
+            }
+            if (lastSequence != 0 && sequence > lastSequence + 1) {
+                DebugLog("Market feed gap: expected " + std::to_string(lastSequence + 1) +
+                    ", got " + std::to_string(sequence) + "\n");
+                m_gaps++;
+                inSequence = false;
+            }
+            lastSequence = sequence;
+        }
+
+        m_live = true;
+
+        std::string type = parsed.value("type", std::string());
+        if (type == "tick") {
+            PriceData data;
+            data.symbol = parsed.value("symbol", std::string());
+            data.price = parsed.value("price", 0.0);
+            data.volume24h = parsed.value("volume_24h", 0.0);
+            data.percentChange24h = parsed.value("percent_change_24h", 0.0);
+            data.timestamp = parsed.value("timestamp", 0.0);
+            data.close = data.price;
+
+            if (!data.symbol.empty() && data.price > 0.0) {
+                data.instrument = InstrumentRegistry::Instance().Intern(data.symbol);
+                m_ticks++;
+                m_callback(data);
+            }
+        }
+        else if (type == "error") {
+            DebugLog("Market feed error: " + parsed.value("message", std::string()) + "\n");
+        }
+    }
+    catch (const nlohmann::json::exception& e) {
+        DebugLog("Market feed sent malformed message: " + std::string(e.what()) + "\n");
+    }
+
+    return inSequence;
+}
@@ -0,0 +1,27 @@
+#include "MarketState.h"
+
+void MarketState::Publish(const PriceData& data, bool isRealData) {
+    if (data.instrument == INVALID_INSTRUMENT) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_publishMutex);
+
+    if (data.instrument >= m_current.quotes.size()) {
+        m_current.quotes.resize(data.instrument + 1);
+    }
+
+    m_current.version++;
+    MarketQuote& quote = m_current.quotes[data.instrument];
+    quote.price = data.price;
+    quote.percentChange24h = data.percentChange24h;
+    quote.volume24h = data.volume24h;
+    quote.isRealData = isRealData;
+    quote.sequence = m_current.version;
+
+    // The write buffer keeps its capacity, so this only allocates when an instrument is added
+    MarketSnapshot& snapshot = m_snapshots.GetWriteBuffer();
+    snapshot.quotes.assign(m_current.quotes.begin(), m_current.quotes.end());
+    snapshot.version = m_current.version;
+    m_snapshots.Publish();
+}
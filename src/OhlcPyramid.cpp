@@ -0,0 +1,244 @@
+#include "OhlcPyramid.h"
+#include <algorithm>
+#include <limits>
+
+void OhlcPyramid::Build(const OhlcvSpans& bars) {
+    Update(bars, 0);
+}
+
+void OhlcPyramid::Update(const OhlcvSpans& bars, size_t firstChanged) {
+    m_base = bars;
+
+    // Level 1 down to a single bucket; levels are rebuilt in place so a refresh of a
+    // similar size reuses their memory
+    size_t barCount = bars.Count();
+    size_t levelCount = 0;
+    if (barCount > 1) {
+        levelCount = 1;
+        for (size_t count = (barCount + BASE_BARS_PER_BUCKET - 1) / BASE_BARS_PER_BUCKET; count > 1;
+            count = (count + 1) / 2) {
+            levelCount++;
+        }
+    }
+    m_levels.resize(levelCount);
+
+    // The first changed bar's bucket, and everything after it, at each level
+    size_t firstBucket = firstChanged / BASE_BARS_PER_BUCKET;
+    for (size_t i = 0; i < levelCount; i++) {
+        if (i == 0) {
+            MergeBase(m_base, m_levels[0], firstBucket);
+        }
+        else {
+            firstBucket /= 2;
+            MergeLevel(GetLevel(i), m_levels[i], firstBucket);
+        }
+    }
+}
+
+void OhlcPyramid::Clear() {
+    m_base = OhlcvSpans();
+    m_levels.clear();
+}
+
+OhlcPyramid::Level OhlcPyramid::GetLevel(size_t level) const {
+    Level result;
+    if (level == 0 || level > m_levels.size()) {
+        return result;
+    }
+
+    const LevelData& data = m_levels[level - 1];
+    result.columns.timestamps = data.timestamps.data();
+    result.columns.opens = data.opens.data();
+    result.columns.highs = data.highs.data();
+    result.columns.lows = data.lows.data();
+    result.columns.closes = data.closes.data();
+    result.columns.count = data.timestamps.size();
+    result.closeMins = data.closeMins.data();
+    result.closeMaxs = data.closeMaxs.data();
+    result.closeMinFirst = data.closeMinFirst.data();
+    result.barsPerBucket = BASE_BARS_PER_BUCKET << (level - 1);
+    return result;
+}
+
+OhlcPyramid::Level OhlcPyramid::SelectLevel(double visibleBars, double maxBuckets) const {
+    if (m_levels.empty() || visibleBars <= maxBuckets * BASE_BARS_PER_BUCKET) {
+        return GetLevel(0);
+    }
+
+    size_t level = 1;
+    double buckets = visibleBars / BASE_BARS_PER_BUCKET;
+    while (level < m_levels.size() && buckets > maxBuckets) {
+        level++;
+        buckets /= 2.0;
+    }
+    return GetLevel(level);
+}
+
+bool OhlcPyramid::GetPriceRange(size_t first, size_t last, double& low, double& high) const {
+    return GetRange(first, last, false, low, high);
+}
+
+bool OhlcPyramid::GetCloseRange(size_t first, size_t last, double& low, double& high) const {
+    return GetRange(first, last, true, low, high);
+}
+
+bool OhlcPyramid::GetRange(size_t first, size_t last, bool closes, double& low, double& high) const {
+    last = std::min(last, m_base.Count());
+    if (first >= last) {
+        return false;
+    }
+
+    low = std::numeric_limits<double>::infinity();
+    high = -std::numeric_limits<double>::infinity();
+
+    // Bars outside whole level 1 buckets are read one by one
+    auto scanBars = [&](const OhlcvColumns& part, size_t from, size_t to) {
+        const double* lows = closes ? part.closes : part.lows;
+        const double* highs = closes ? part.closes : part.highs;
+        for (size_t i = from; i < to; i++) {
+            low = std::min(low, lows[i]);
+            high = std::max(high, highs[i]);
+        }
+    };
+    size_t wholeFirst = (first + BASE_BARS_PER_BUCKET - 1) / BASE_BARS_PER_BUCKET * BASE_BARS_PER_BUCKET;
+    size_t wholeLast = last / BASE_BARS_PER_BUCKET * BASE_BARS_PER_BUCKET;
+    if (wholeFirst >= wholeLast) {
+        m_base.ForEachPart(first, last, scanBars);
+        return true;
+    }
+    m_base.ForEachPart(first, wholeFirst, scanBars);
+    m_base.ForEachPart(wholeLast, last, scanBars);
+    first = wholeFirst / BASE_BARS_PER_BUCKET;
+    last = wholeLast / BASE_BARS_PER_BUCKET;
+
+    // From there on, buckets only partly inside the range are split into the level below,
+    // so each level contributes at most one bucket at either end and the rest moves up
+    for (size_t index = 1; first < last; index++) {
+        Level level = GetLevel(index);
+        const double* lows = closes ? level.closeMins : level.columns.lows;
+        const double* highs = closes ? level.closeMaxs : level.columns.highs;
+
+        if (first % 2 == 1) {
+            low = std::min(low, lows[first]);
+            high = std::max(high, highs[first]);
+            first++;
+        }
+        if (last % 2 == 1) {
+            last--;
+            low = std::min(low, lows[last]);
+            high = std::max(high, highs[last]);
+        }
+
+        first /= 2;
+        last /= 2;
+    }
+
+    return true;
+}
+
+size_t OhlcPyramid::ResizeLevel(LevelData& level, size_t count, size_t firstBucket) {
+    // A level that has just appeared (or grown) has nothing to keep past its old end
+    firstBucket = std::min(firstBucket, level.timestamps.size());
+
+    level.timestamps.resize(count);
+    level.opens.resize(count);
+    level.highs.resize(count);
+    level.lows.resize(count);
+    level.closes.resize(count);
+    level.closeMins.resize(count);
+    level.closeMaxs.resize(count);
+    level.closeMinFirst.resize(count);
+    return firstBucket;
+}
+
+void OhlcPyramid::MergeBase(const OhlcvSpans& bars, LevelData& level, size_t firstBucket) {
+    size_t barCount = bars.Count();
+    size_t count = (barCount + BASE_BARS_PER_BUCKET - 1) / BASE_BARS_PER_BUCKET;
+    firstBucket = ResizeLevel(level, count, firstBucket);
+
+    // Each bucket merges the next BASE_BARS_PER_BUCKET bars, which may straddle the two
+    // parts of the series; the last bucket may have fewer
+    for (size_t i = firstBucket; i < count; i++) {
+        size_t first = i * BASE_BARS_PER_BUCKET;
+        size_t last = std::min(first + BASE_BARS_PER_BUCKET, barCount);
+
+        double high = -std::numeric_limits<double>::infinity();
+        double low = std::numeric_limits<double>::infinity();
+        double closeMin = std::numeric_limits<double>::infinity();
+        double closeMax = -std::numeric_limits<double>::infinity();
+        size_t minAt = 0;
+        size_t maxAt = 0;
+        size_t at = first;
+        bars.ForEachPart(first, last, [&](const OhlcvColumns& part, size_t from, size_t to) {
+            if (at == first) {
+                level.timestamps[i] = part.timestamps[from];
+                level.opens[i] = part.opens[from];
+            }
+            for (size_t j = from; j < to; j++, at++) {
+                high = std::max(high, part.highs[j]);
+                low = std::min(low, part.lows[j]);
+                if (part.closes[j] < closeMin) {
+                    closeMin = part.closes[j];
+                    minAt = at;
+                }
+                if (part.closes[j] > closeMax) {
+                    closeMax = part.closes[j];
+                    maxAt = at;
+                }
+            }
+            level.closes[i] = part.closes[to - 1];
+        });
+
+        level.highs[i] = high;
+        level.lows[i] = low;
+        level.closeMins[i] = closeMin;
+        level.closeMaxs[i] = closeMax;
+
+        // Extremes from a single close (a flat bucket) can be visited in either order
+        level.closeMinFirst[i] = minAt <= maxAt;
+    }
+}
+
+void OhlcPyramid::MergeLevel(const Level& below, LevelData& level, size_t firstBucket) {
+    const OhlcvColumns& columns = below.columns;
+    size_t count = (columns.count + 1) / 2;
+    firstBucket = ResizeLevel(level, count, firstBucket);
+
+    // Each bucket merges the next two buckets below; the last may have one
+    for (size_t i = firstBucket; i < count; i++) {
+        size_t first = i * 2;
+        size_t last = std::min(first + 2, columns.count);
+
+        double high = columns.highs[first];
+        double low = columns.lows[first];
+        size_t minAt = first;
+        size_t maxAt = first;
+        for (size_t j = first + 1; j < last; j++) {
+            high = std::max(high, columns.highs[j]);
+            low = std::min(low, columns.lows[j]);
+            if (below.closeMins[j] < below.closeMins[minAt]) {
+                minAt = j;
+            }
+            if (below.closeMaxs[j] > below.closeMaxs[maxAt]) {
+                maxAt = j;
+            }
+        }
+
+        level.timestamps[i] = columns.timestamps[first];
+        level.opens[i] = columns.opens[first];
+        level.closes[i] = columns.closes[last - 1];
+        level.highs[i] = high;
+        level.lows[i] = low;
+        level.closeMins[i] = below.closeMins[minAt];
+        level.closeMaxs[i] = below.closeMaxs[maxAt];
+
+        // Extremes from different buckets below are ordered by those buckets; from the
+        // same one, by its own order
+        if (minAt != maxAt) {
+            level.closeMinFirst[i] = minAt < maxAt;
+        }
+        else {
+            level.closeMinFirst[i] = below.closeMinFirst[minAt];
+        }
+    }
+}
@@ -123,27 +123,42 @@ void PositionsPanel::Render() {
 
 void PositionsPanel::AddPosition(const Position& position) {
     m_positions.push_back(position);
+
+    Position& added = m_positions.back();
+    if (added.instrument == INVALID_INSTRUMENT) {
+        added.instrument = InstrumentRegistry::Instance().Intern(added.symbol);
+    }
+
+    if (added.isOpen) {
+        if (added.instrument >= m_openPositions.size()) {
+            m_openPositions.resize(added.instrument + 1);
+        }
+        m_openPositions[added.instrument].push_back(m_positions.size() - 1);
+    }
 }
 
-void PositionsPanel::UpdatePositionPrice(const std::string& symbol, double price) {
-    for (auto& position : m_positions) {
-        if (position.symbol == symbol && position.isOpen) {
-            position.currentPrice = price;
+void PositionsPanel::UpdatePositionPrice(InstrumentId instrument, double price) {
+    if (instrument >= m_openPositions.size()) {
+        return;
+    }
 
-            // Calculate profit/loss
-            double priceChange = price - position.entryPrice;
+    for (size_t index : m_openPositions[instrument]) {
+        Position& position = m_positions[index];
+        position.currentPrice = price;
 
-            // Calculate P&L based on position type
-            if (position.type == "Long") {
-                position.profitLoss = priceChange * position.amount;
-            }
-            else {
-                position.profitLoss = -priceChange * position.amount;
-            }
+        // Calculate profit/loss
+        double priceChange = price - position.entryPrice;
 
-            // Calculate percentage change
-            position.profitLossPercent = (priceChange / position.entryPrice) * 100.0;
+        // Calculate P&L based on position type
+        if (position.type == "Long") {
+            position.profitLoss = priceChange * position.amount;
         }
+        else {
+            position.profitLoss = -priceChange * position.amount;
+        }
+
+        // Calculate percentage change
+        position.profitLossPercent = (priceChange / position.entryPrice) * 100.0;
     }
 }
 
@@ -152,6 +167,9 @@ void PositionsPanel::ClosePosition(size_t index) {
         // Mark as closed
         m_positions[index].isOpen = false;
 
+        std::vector<size_t>& open = m_openPositions[m_positions[index].instrument];
+        open.erase(std::find(open.begin(), open.end(), index));
+
         // Call the callback if set
         if (m_positionCloseCallback) {
             m_positionCloseCallback(index, m_positions[index]);
@@ -0,0 +1,400 @@
+#include "PosixHttpTransport.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    // Bytes requested from the socket per read
+    const size_t READ_CHUNK_SIZE = 16 * 1024;
+
+    // Pieces of an http:// URL
+    struct ParsedUrl {
+        std::string host;
+        int port = 80;
+        std::string path;
+    };
+
+    bool ParseUrl(const std::string& url, ParsedUrl& parsed, std::string& error) {
+        const std::string scheme = "http://";
+        if (url.compare(0, scheme.size(), scheme) != 0) {
+            error = "Only http:// URLs are supported by the POSIX transport";
+            return false;
+        }
+
+        size_t hostStart = scheme.size();
+        size_t pathStart = url.find('/', hostStart);
+        std::string authority = url.substr(hostStart, pathStart == std::string::npos ? std::string::npos : pathStart - hostStart);
+        parsed.path = pathStart == std::string::npos ? "/" : url.substr(pathStart);
+
+        size_t colon = authority.rfind(':');
+        if (colon != std::string::npos) {
+            parsed.host = authority.substr(0, colon);
+            parsed.port = std::atoi(authority.c_str() + colon + 1);
+        }
+        else {
+            parsed.host = authority;
+        }
+
+        if (parsed.host.empty() || parsed.port <= 0 || parsed.port > 65535) {
+            error = "Failed to parse URL: " + url;
+            return false;
+        }
+        return true;
+    }
+
+    std::string ToLower(std::string value) {
+        std::transform(value.begin(), value.end(), value.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return value;
+    }
+
+    std::string Trim(const std::string& value) {
+        size_t start = value.find_first_not_of(" \t");
+        size_t end = value.find_last_not_of(" \t\r");
+        return start == std::string::npos ? std::string() : value.substr(start, end - start + 1);
+    }
+}
+
+PosixHttpTransport::PosixHttpTransport(size_t maxConnections, int idleTimeoutSeconds, int requestTimeoutSeconds)
+    : m_connections(maxConnections, idleTimeoutSeconds, &PosixHttpTransport::Close),
+      m_requestTimeoutMs(requestTimeoutSeconds * 1000) {
+}
+
+PosixHttpTransport::~PosixHttpTransport() {
+    m_connections.CloseAll();
+}
+
+bool PosixHttpTransport::Get(
+    const std::string& url,
+    const std::map<std::string, std::string>& headers,
+    HttpResponse& response,
+    std::string& error
+) {
+    ParsedUrl parsed;
+    if (!ParseUrl(url, parsed, error)) {
+        return false;
+    }
+
+    // Build the request once; it may be sent twice if a pooled connection turns out to be stale
+    std::string request = "GET " + parsed.path + " HTTP/1.1\r\n";
+    request += "Host: " + parsed.host + (parsed.port != 80 ? ":" + std::to_string(parsed.port) : "") + "\r\n";
+    request += "Connection: keep-alive\r\n";
+    request += "User-Agent: TradingPlatform/1.0\r\n";
+    for (const auto& header : headers) {
+        request += header.first + ": " + header.second + "\r\n";
+    }
+    request += "\r\n";
+
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(m_requestTimeoutMs);
+    ConnectionKey key(parsed.host, parsed.port);
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        Connection connection;
+        bool reused = m_connections.Acquire(key, connection);
+        if (!reused && !Connect(parsed.host, parsed.port, connection, deadline, error)) {
+            m_connections.Abandon();
+            return false;
+        }
+
+        bool keepAlive = false;
+        Exchange result = Request(connection, request, response, keepAlive, deadline, error);
+        m_connections.Release(key, connection, result == Exchange::Done && keepAlive);
+
+        if (result == Exchange::Done) {
+            return true;
+        }
+
+        // Only a reused connection gets a second try on a fresh socket
+        if (result == Exchange::Failed || !reused) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+PosixHttpTransport::Exchange PosixHttpTransport::Request(const Connection& connection,
+    const std::string& request, HttpResponse& response, bool& keepAlive,
+    Clock::time_point deadline, std::string& error) {
+    if (!SendAll(connection, request, deadline, error)) {
+        return Exchange::Stale;
+    }
+
+    // The response is read straight into the body buffer, which keeps the
+    // capacity of earlier responses when the caller pools it
+    std::string& data = response.body;
+    data.clear();
+
+    // Read until the header block is complete
+    size_t headerEnd = std::string::npos;
+    while ((headerEnd = data.find("\r\n\r\n")) == std::string::npos) {
+        long bytesRead = ReadSome(connection, data, deadline);
+        if (bytesRead <= 0) {
+            error = bytesRead == 0 ? "Connection closed before response" : "Failed to receive response";
+            return data.empty() ? Exchange::Stale : Exchange::Failed;
+        }
+    }
+
+    // Status line: HTTP/1.1 200 OK
+    size_t lineEnd = data.find("\r\n");
+    std::string statusLine = data.substr(0, lineEnd);
+    size_t space = statusLine.find(' ');
+    if (space == std::string::npos) {
+        error = "Malformed status line: " + statusLine;
+        return Exchange::Failed;
+    }
+    response.statusCode = std::atoi(statusLine.c_str() + space + 1);
+    bool isHttp11 = statusLine.compare(0, 8, "HTTP/1.1") == 0;
+
+    // Header fields (names are case-insensitive), handed back in the response
+    std::map<std::string, std::string>& fields = response.headers;
+    fields.clear();
+    size_t pos = lineEnd + 2;
+    while (pos < headerEnd) {
+        size_t next = data.find("\r\n", pos);
+        std::string line = data.substr(pos, next - pos);
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            fields[ToLower(line.substr(0, colon))] = Trim(line.substr(colon + 1));
+        }
+        pos = next + 2;
+    }
+
+    auto field = [&fields](const char* name) {
+        auto it = fields.find(name);
+        return it != fields.end() ? ToLower(it->second) : std::string();
+        };
+
+    std::string connectionField = field("connection");
+    keepAlive = isHttp11 ? connectionField != "close" : connectionField == "keep-alive";
+
+    // Drop the header block; what is left is the start of the body
+    data.erase(0, headerEnd + 4);
+
+    // Responses without a body
+    if (response.statusCode == 204 || response.statusCode == 304 ||
+        (response.statusCode >= 100 && response.statusCode < 200)) {
+        data.clear();
+        return Exchange::Done;
+    }
+
+    if (field("transfer-encoding").find("chunked") != std::string::npos) {
+        // Chunked body: <hex size>\r\n<data>\r\n ... 0\r\n<trailers>\r\n
+        // Decoded in place: chunk data is moved down over the framing in front of it
+        size_t decoded = 0;
+        size_t cursor = 0;
+        while (true) {
+            size_t sizeEnd;
+            while ((sizeEnd = data.find("\r\n", cursor)) == std::string::npos) {
+                if (ReadSome(connection, data, deadline) <= 0) {
+                    error = "Truncated chunked response";
+                    return Exchange::Failed;
+                }
+            }
+
+            size_t chunkSize = std::strtoul(data.c_str() + cursor, nullptr, 16);
+            size_t chunkStart = sizeEnd + 2;
+
+            if (chunkSize == 0) {
+                // Skip optional trailers up to the terminating blank line
+                while (data.compare(chunkStart, 2, "\r\n") != 0 &&
+                    data.find("\r\n\r\n", sizeEnd) == std::string::npos) {
+                    if (ReadSome(connection, data, deadline) <= 0) {
+                        error = "Truncated chunked response";
+                        return Exchange::Failed;
+                    }
+                }
+                data.resize(decoded);
+                return Exchange::Done;
+            }
+
+            while (data.size() < chunkStart + chunkSize + 2) {
+                if (ReadSome(connection, data, deadline) <= 0) {
+                    error = "Truncated chunked response";
+                    return Exchange::Failed;
+                }
+            }
+
+            std::memmove(&data[decoded], data.data() + chunkStart, chunkSize);
+            decoded += chunkSize;
+            cursor = chunkStart + chunkSize + 2;
+
+            // Close the gap left by the framing once it grows
+            if (cursor - decoded > READ_CHUNK_SIZE) {
+                data.erase(decoded, cursor - decoded);
+                cursor = decoded;
+            }
+        }
+    }
+
+    auto contentLength = fields.find("content-length");
+    if (contentLength != fields.end()) {
+        size_t length = std::strtoul(contentLength->second.c_str(), nullptr, 10);
+
+        // Room for the whole body plus one read's worth of slack, so it never reallocates
+        data.reserve(length + READ_CHUNK_SIZE);
+
+        while (data.size() < length) {
+            if (ReadSome(connection, data, deadline) <= 0) {
+                error = "Truncated response body";
+                return Exchange::Failed;
+            }
+        }
+        data.resize(length);
+        return Exchange::Done;
+    }
+
+    // No framing: the body runs until the server closes the connection
+    while (true) {
+        long bytesRead = ReadSome(connection, data, deadline);
+        if (bytesRead == 0) {
+            keepAlive = false;
+            return Exchange::Done;
+        }
+        if (bytesRead < 0) {
+            error = "Failed to receive response";
+            return Exchange::Failed;
+        }
+    }
+}
+
+bool PosixHttpTransport::Connect(const std::string& host, int port, Connection& connection,
+    Clock::time_point deadline, std::string& error) {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* addresses = nullptr;
+    int status = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses);
+    if (status != 0) {
+        error = "Failed to resolve " + host + ": " + gai_strerror(status);
+        return false;
+    }
+
+    error = "Failed to connect to server";
+    for (addrinfo* address = addresses; address; address = address->ai_next) {
+        Connection candidate;
+        candidate.socket = socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, address->ai_protocol);
+        if (candidate.socket < 0) {
+            continue;
+        }
+
+        int noDelay = 1;
+        setsockopt(candidate.socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        candidate.epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (candidate.epoll < 0) {
+            Close(candidate);
+            continue;
+        }
+
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLOUT;
+        event.data.fd = candidate.socket;
+        epoll_ctl(candidate.epoll, EPOLL_CTL_ADD, candidate.socket, &event);
+
+        // Non-blocking connect completes when the socket becomes writable
+        if (connect(candidate.socket, address->ai_addr, address->ai_addrlen) < 0 && errno != EINPROGRESS) {
+            Close(candidate);
+            continue;
+        }
+
+        int socketError = 0;
+        socklen_t length = sizeof(socketError);
+        if (!WaitFor(candidate, EPOLLOUT, deadline) ||
+            getsockopt(candidate.socket, SOL_SOCKET, SO_ERROR, &socketError, &length) < 0 || socketError != 0) {
+            error = "Failed to connect to server: " + std::string(socketError ? std::strerror(socketError) : "timed out");
+            Close(candidate);
+            continue;
+        }
+
+        connection = candidate;
+        freeaddrinfo(addresses);
+        return true;
+    }
+
+    freeaddrinfo(addresses);
+    return false;
+}
+
+void PosixHttpTransport::Close(Connection connection) {
+    if (connection.epoll >= 0) {
+        close(connection.epoll);
+    }
+    if (connection.socket >= 0) {
+        close(connection.socket);
+    }
+}
+
+bool PosixHttpTransport::WaitFor(const Connection& connection, uint32_t events, Clock::time_point deadline) {
+    // Re-arm for just the events we care about (level-triggered)
+    epoll_event event = {};
+    event.events = events;
+    event.data.fd = connection.socket;
+    epoll_ctl(connection.epoll, EPOLL_CTL_MOD, connection.socket, &event);
+
+    while (true) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+        if (remaining <= 0) {
+            return false;
+        }
+
+        epoll_event ready = {};
+        int count = epoll_wait(connection.epoll, &ready, 1, static_cast<int>(remaining));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        // Errors and hang-ups are reported as ready so the next call surfaces them
+        return count > 0;
+    }
+}
+
+long PosixHttpTransport::ReadSome(const Connection& connection, std::string& data, Clock::time_point deadline) {
+    while (true) {
+        size_t oldSize = data.size();
+        data.resize(oldSize + READ_CHUNK_SIZE);
+        ssize_t bytesRead = recv(connection.socket, &data[oldSize], READ_CHUNK_SIZE, 0);
+        data.resize(oldSize + std::max<ssize_t>(bytesRead, 0));
+
+        if (bytesRead >= 0) {
+            return static_cast<long>(bytesRead);
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if ((errno != EAGAIN && errno != EWOULDBLOCK) || !WaitFor(connection, EPOLLIN, deadline)) {
+            return -1;
+        }
+    }
+}
+
+bool PosixHttpTransport::SendAll(const Connection& connection, const std::string& data,
+    Clock::time_point deadline, std::string& error) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t result = send(connection.socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (result > 0) {
+            sent += static_cast<size_t>(result);
+            continue;
+        }
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && WaitFor(connection, EPOLLOUT, deadline)) {
+            continue;
+        }
+
+        error = "Failed to send request: " + std::string(std::strerror(errno));
+        return false;
+    }
+    return true;
+}
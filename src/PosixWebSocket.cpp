@@ -0,0 +1,363 @@
+#include "PosixWebSocket.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+    // Largest message accepted from the server
+    const uint64_t MAX_MESSAGE_SIZE = 16 * 1024 * 1024;
+
+    // Bytes requested from the socket per read
+    const size_t READ_CHUNK_SIZE = 16 * 1024;
+
+    enum Opcode : uint8_t {
+        OPCODE_CONTINUATION = 0x0,
+        OPCODE_TEXT = 0x1,
+        OPCODE_BINARY = 0x2,
+        OPCODE_CLOSE = 0x8,
+        OPCODE_PING = 0x9,
+        OPCODE_PONG = 0xA
+    };
+
+    // Pieces of a ws:// URL
+    struct ParsedUrl {
+        std::string host;
+        int port = 80;
+        std::string path;
+    };
+
+    bool ParseUrl(const std::string& url, ParsedUrl& parsed, std::string& error) {
+        const std::string scheme = "ws://";
+        if (url.compare(0, scheme.size(), scheme) != 0) {
+            error = "Only ws:// URLs are supported by the POSIX WebSocket";
+            return false;
+        }
+
+        size_t hostStart = scheme.size();
+        size_t pathStart = url.find('/', hostStart);
+        std::string authority = url.substr(hostStart, pathStart == std::string::npos ? std::string::npos : pathStart - hostStart);
+        parsed.path = pathStart == std::string::npos ? "/" : url.substr(pathStart);
+
+        size_t colon = authority.rfind(':');
+        if (colon != std::string::npos) {
+            parsed.host = authority.substr(0, colon);
+            parsed.port = std::atoi(authority.c_str() + colon + 1);
+        }
+        else {
+            parsed.host = authority;
+        }
+
+        if (parsed.host.empty() || parsed.port <= 0 || parsed.port > 65535) {
+            error = "Failed to parse URL: " + url;
+            return false;
+        }
+        return true;
+    }
+
+    std::string Base64Encode(const unsigned char* data, size_t size) {
+        static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        std::string encoded;
+        for (size_t i = 0; i < size; i += 3) {
+            uint32_t group = static_cast<uint32_t>(data[i]) << 16;
+            if (i + 1 < size) group |= static_cast<uint32_t>(data[i + 1]) << 8;
+            if (i + 2 < size) group |= data[i + 2];
+
+            encoded += alphabet[(group >> 18) & 0x3F];
+            encoded += alphabet[(group >> 12) & 0x3F];
+            encoded += i + 1 < size ? alphabet[(group >> 6) & 0x3F] : '=';
+            encoded += i + 2 < size ? alphabet[group & 0x3F] : '=';
+        }
+        return encoded;
+    }
+}
+
+PosixWebSocket::PosixWebSocket()
+    : m_maskGenerator(std::random_device()()) {
+}
+
+PosixWebSocket::~PosixWebSocket() {
+    int socket = m_socket.exchange(-1);
+    if (socket >= 0) {
+        close(socket);
+    }
+}
+
+bool PosixWebSocket::Connect(const std::string& url, int timeoutSeconds, std::string& error) {
+    ParsedUrl parsed;
+    if (!ParseUrl(url, parsed, error)) {
+        return false;
+    }
+    m_timeoutMs = timeoutSeconds * 1000;
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* addresses = nullptr;
+    int status = getaddrinfo(parsed.host.c_str(), std::to_string(parsed.port).c_str(), &hints, &addresses);
+    if (status != 0) {
+        error = "Failed to resolve " + parsed.host + ": " + gai_strerror(status);
+        return false;
+    }
+
+    // Connect without blocking past the timeout, then go back to blocking reads guarded by poll
+    for (addrinfo* address = addresses; address; address = address->ai_next) {
+        int socket = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (socket < 0) {
+            continue;
+        }
+        m_socket = socket;
+
+        int flags = fcntl(socket, F_GETFL, 0);
+        fcntl(socket, F_SETFL, flags | O_NONBLOCK);
+
+        bool connected = ::connect(socket, address->ai_addr, address->ai_addrlen) == 0;
+        if (!connected && errno == EINPROGRESS) {
+            pollfd waitFor = { socket, POLLOUT, 0 };
+            int socketError = 0;
+            socklen_t length = sizeof(socketError);
+            connected = poll(&waitFor, 1, m_timeoutMs) == 1 &&
+                getsockopt(socket, SOL_SOCKET, SO_ERROR, &socketError, &length) == 0 && socketError == 0;
+        }
+
+        if (connected) {
+            fcntl(socket, F_SETFL, flags);
+            break;
+        }
+
+        m_socket = -1;
+        close(socket);
+    }
+    freeaddrinfo(addresses);
+
+    if (m_socket < 0) {
+        error = "Failed to connect to " + parsed.host + ":" + std::to_string(parsed.port);
+        return false;
+    }
+
+    // Ticks are small and latency-sensitive
+    int noDelay = 1;
+    setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    // Upgrade request with a random key
+    unsigned char keyBytes[16];
+    for (auto& byte : keyBytes) {
+        byte = static_cast<unsigned char>(m_maskGenerator());
+    }
+
+    std::string request =
+        "GET " + parsed.path + " HTTP/1.1\r\n"
+        "Host: " + parsed.host + ":" + std::to_string(parsed.port) + "\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: " + Base64Encode(keyBytes, sizeof(keyBytes)) + "\r\n"
+        "Sec-WebSocket-Version: 13\r\n"
+        "\r\n";
+    if (!WriteAll(request.data(), request.size(), error)) {
+        return false;
+    }
+
+    // Read up to the end of the response headers; anything after them is already frame data
+    std::string headers;
+    while (headers.size() < 4 || headers.compare(headers.size() - 4, 4, "\r\n\r\n") != 0) {
+        char c;
+        if (!ReadExact(&c, 1, error)) {
+            return false;
+        }
+        headers += c;
+        if (headers.size() > 16 * 1024) {
+            error = "WebSocket handshake response too large";
+            return false;
+        }
+    }
+
+    // The accept hash is not checked; a server that switches protocols is taken at its word
+    if (headers.compare(0, 12, "HTTP/1.1 101") != 0) {
+        error = "WebSocket upgrade refused: " + headers.substr(0, headers.find("\r\n"));
+        return false;
+    }
+
+    return true;
+}
+
+bool PosixWebSocket::Send(const std::string& message, std::string& error) {
+    return SendFrame(OPCODE_TEXT, message, error);
+}
+
+bool PosixWebSocket::Receive(std::string& message, std::string& error) {
+    message.clear();
+
+    for (;;) {
+        unsigned char header[2];
+        if (!ReadExact(reinterpret_cast<char*>(header), sizeof(header), error)) {
+            return false;
+        }
+
+        bool final = (header[0] & 0x80) != 0;
+        uint8_t opcode = header[0] & 0x0F;
+        bool masked = (header[1] & 0x80) != 0;
+        uint64_t length = header[1] & 0x7F;
+
+        // Extended lengths are big-endian
+        if (length >= 126) {
+            unsigned char extended[8];
+            size_t size = length == 126 ? 2 : 8;
+            if (!ReadExact(reinterpret_cast<char*>(extended), size, error)) {
+                return false;
+            }
+            length = 0;
+            for (size_t i = 0; i < size; i++) {
+                length = (length << 8) | extended[i];
+            }
+        }
+
+        if (length > MAX_MESSAGE_SIZE || message.size() + length > MAX_MESSAGE_SIZE) {
+            error = "WebSocket message too large";
+            return false;
+        }
+
+        unsigned char mask[4] = {};
+        if (masked && !ReadExact(reinterpret_cast<char*>(mask), sizeof(mask), error)) {
+            return false;
+        }
+
+        std::string payload(static_cast<size_t>(length), '\0');
+        if (length > 0 && !ReadExact(&payload[0], payload.size(), error)) {
+            return false;
+        }
+        if (masked) {
+            for (size_t i = 0; i < payload.size(); i++) {
+                payload[i] = static_cast<char>(payload[i] ^ mask[i % 4]);
+            }
+        }
+
+        switch (opcode) {
+        case OPCODE_CLOSE:
+            // Echo the close and give up on the connection
+            SendFrame(OPCODE_CLOSE, payload.substr(0, 2), error);
+            error = "WebSocket closed by server";
+            return false;
+        case OPCODE_PING:
+            if (!SendFrame(OPCODE_PONG, payload, error)) {
+                return false;
+            }
+            break;
+        case OPCODE_PONG:
+            break;
+        case OPCODE_TEXT:
+        case OPCODE_BINARY:
+        case OPCODE_CONTINUATION:
+            message += payload;
+            if (final) {
+                return true;
+            }
+            break;
+        default:
+            error = "Unknown WebSocket opcode " + std::to_string(opcode);
+            return false;
+        }
+    }
+}
+
+void PosixWebSocket::Abort() {
+    // shutdown() wakes a blocked poll or recv; the descriptor is closed by the destructor
+    int socket = m_socket;
+    if (socket >= 0) {
+        shutdown(socket, SHUT_RDWR);
+    }
+}
+
+bool PosixWebSocket::SendFrame(uint8_t opcode, const std::string& payload, std::string& error) {
+    std::string frame;
+    frame.reserve(payload.size() + 14);
+    frame += static_cast<char>(0x80 | opcode);
+
+    if (payload.size() < 126) {
+        frame += static_cast<char>(0x80 | payload.size());
+    }
+    else if (payload.size() <= 0xFFFF) {
+        frame += static_cast<char>(0x80 | 126);
+        frame += static_cast<char>((payload.size() >> 8) & 0xFF);
+        frame += static_cast<char>(payload.size() & 0xFF);
+    }
+    else {
+        frame += static_cast<char>(0x80 | 127);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            frame += static_cast<char>((static_cast<uint64_t>(payload.size()) >> shift) & 0xFF);
+        }
+    }
+
+    uint32_t maskValue = m_maskGenerator();
+    unsigned char mask[4];
+    std::memcpy(mask, &maskValue, sizeof(mask));
+    frame.append(reinterpret_cast<const char*>(mask), sizeof(mask));
+
+    for (size_t i = 0; i < payload.size(); i++) {
+        frame += static_cast<char>(payload[i] ^ mask[i % 4]);
+    }
+
+    return WriteAll(frame.data(), frame.size(), error);
+}
+
+bool PosixWebSocket::WriteAll(const char* data, size_t size, std::string& error) {
+    while (size > 0) {
+        ssize_t sent = ::send(m_socket, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            error = "WebSocket send failed: " + std::string(std::strerror(errno));
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool PosixWebSocket::ReadExact(char* data, size_t size, std::string& error) {
+    while (size > 0) {
+        if (m_bufferPos < m_buffer.size()) {
+            size_t take = std::min(size, m_buffer.size() - m_bufferPos);
+            std::memcpy(data, m_buffer.data() + m_bufferPos, take);
+            m_bufferPos += take;
+            data += take;
+            size -= take;
+            continue;
+        }
+
+        pollfd waitFor = { m_socket, POLLIN, 0 };
+        int ready = poll(&waitFor, 1, m_timeoutMs);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready == 0) {
+            error = "WebSocket receive timed out";
+            return false;
+        }
+
+        m_buffer.resize(READ_CHUNK_SIZE);
+        m_bufferPos = 0;
+        ssize_t received = ready > 0 ? ::recv(m_socket, &m_buffer[0], m_buffer.size(), 0) : -1;
+        if (received < 0 && errno == EINTR) {
+            m_buffer.clear();
+            continue;
+        }
+        if (received <= 0) {
+            m_buffer.clear();
+            error = received == 0 ? "WebSocket connection closed" : "WebSocket receive failed: " + std::string(std::strerror(errno));
+            return false;
+        }
+        m_buffer.resize(static_cast<size_t>(received));
+    }
+    return true;
+}
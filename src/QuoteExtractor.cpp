@@ -0,0 +1,182 @@
+#include "QuoteExtractor.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+
+namespace {
+    // Depths of the interesting objects: {"data": [ {entry "quote": {"USD": {...}}} ]}
+    constexpr size_t ROOT_DEPTH = 1;
+    constexpr size_t ENTRY_DEPTH = 3;
+    constexpr size_t QUOTE_DEPTH = 4;
+    constexpr size_t USD_DEPTH = 5;
+
+    class QuoteSaxHandler : public nlohmann::json_sax<nlohmann::json> {
+    public:
+        QuoteSaxHandler(const std::vector<std::string>& symbols, QuoteExtractionResult& result)
+            : m_symbols(symbols), m_result(result) {
+            // Keys are stored per depth so their buffers get reused between rows
+            m_keys.resize(8);
+        }
+
+        // True once every requested symbol has been extracted
+        bool IsDone() const { return m_done; }
+
+        bool null() override { return true; }
+        bool boolean(bool) override { return true; }
+        bool binary(binary_t&) override { return true; }
+
+        bool number_integer(number_integer_t value) override { return Number(static_cast<double>(value)); }
+        bool number_unsigned(number_unsigned_t value) override { return Number(static_cast<double>(value)); }
+        bool number_float(number_float_t value, const string_t&) override { return Number(value); }
+
+        bool string(string_t& value) override {
+            if (InEntry() && m_depth == ENTRY_DEPTH) {
+                if (m_keys[ENTRY_DEPTH] == "symbol") {
+                    m_entrySymbol = value;
+                }
+                else if (m_keys[ENTRY_DEPTH] == "last_updated") {
+                    m_entry.lastUpdated = value;
+                }
+            }
+            else if (InStatus() && m_keys[2] == "error_message") {
+                m_result.errorMessage = value;
+            }
+            return true;
+        }
+
+        bool start_object(std::size_t) override {
+            Push();
+
+            // A new row under "data" (array element or value keyed by symbol)
+            if (InEntry() && m_depth == ENTRY_DEPTH) {
+                m_entry = ExtractedQuote();
+                m_entrySymbol.clear();
+                m_entryHasQuote = false;
+            }
+            return true;
+        }
+
+        bool end_object() override {
+            if (InEntry() && m_depth == ENTRY_DEPTH) {
+                FinishEntry();
+                if (m_done) {
+                    // Stop the parser; Extract() treats this as success
+                    return false;
+                }
+            }
+            m_depth--;
+            return true;
+        }
+
+        bool start_array(std::size_t) override {
+            Push();
+            return true;
+        }
+
+        bool end_array() override {
+            m_depth--;
+            return true;
+        }
+
+        bool key(string_t& value) override {
+            m_keys[m_depth].assign(value);
+            return true;
+        }
+
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override {
+            return false;
+        }
+
+    private:
+        void Push() {
+            m_depth++;
+            if (m_keys.size() <= m_depth) {
+                m_keys.resize(m_depth + 1);
+            }
+            m_keys[m_depth].clear();
+        }
+
+        bool InEntry() const {
+            return m_depth >= ENTRY_DEPTH && m_keys[ROOT_DEPTH] == "data";
+        }
+
+        bool InStatus() const {
+            return m_depth == 2 && m_keys[ROOT_DEPTH] == "status";
+        }
+
+        bool Number(double value) {
+            if (InStatus() && m_keys[2] == "error_code") {
+                m_result.errorCode = static_cast<int>(value);
+                return true;
+            }
+
+            if (!InEntry() || m_depth != USD_DEPTH ||
+                m_keys[ENTRY_DEPTH] != "quote" || m_keys[QUOTE_DEPTH] != "USD") {
+                return true;
+            }
+
+            const std::string& field = m_keys[USD_DEPTH];
+            if (field == "price") {
+                m_entry.price = value;
+            }
+            else if (field == "volume_24h") {
+                m_entry.volume24h = value;
+            }
+            else if (field == "percent_change_1h") {
+                m_entry.percentChange1h = value;
+            }
+            else if (field == "percent_change_24h") {
+                m_entry.percentChange24h = value;
+            }
+            else if (field == "percent_change_7d") {
+                m_entry.percentChange7d = value;
+            }
+            else if (field == "market_cap") {
+                m_entry.marketCap = value;
+            }
+            else {
+                return true;
+            }
+
+            m_entryHasQuote = true;
+            return true;
+        }
+
+        void FinishEntry() {
+            // Quotes responses key rows by symbol; listings carry it as a field
+            const std::string& symbol = m_entrySymbol.empty() ? m_keys[2] : m_entrySymbol;
+
+            if (!m_entryHasQuote ||
+                std::find(m_symbols.begin(), m_symbols.end(), symbol) == m_symbols.end() ||
+                m_result.quotes.count(symbol) > 0) {
+                return;
+            }
+
+            m_result.quotes[symbol] = std::move(m_entry);
+            m_done = m_result.quotes.size() == m_symbols.size();
+        }
+
+        const std::vector<std::string>& m_symbols;
+        QuoteExtractionResult& m_result;
+
+        // Current nesting depth and the active key at each depth
+        size_t m_depth = 0;
+        std::vector<std::string> m_keys;
+
+        // Row being scanned
+        ExtractedQuote m_entry;
+        std::string m_entrySymbol;
+        bool m_entryHasQuote = false;
+
+        bool m_done = false;
+    };
+}
+
+bool QuoteExtractor::Extract(std::string_view json, const std::vector<std::string>& symbols,
+    QuoteExtractionResult& result) {
+    result = QuoteExtractionResult();
+
+    QuoteSaxHandler handler(symbols, result);
+    bool parsed = nlohmann::json::sax_parse(json.data(), json.data() + json.size(), &handler);
+
+    return parsed || handler.IsDone();
+}
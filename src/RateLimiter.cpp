@@ -0,0 +1,92 @@
+#include "RateLimiter.h"
+#include <algorithm>
+#include <ctime>
+
+namespace {
+    // Days since the epoch in UTC, which is when the provider resets daily usage
+    long long CurrentUtcDay() {
+        return static_cast<long long>(time(nullptr) / (24 * 60 * 60));
+    }
+}
+
+RateLimiter::RateLimiter(double requestsPerMinute, double creditsPerMinute, double creditsPerDay,
+    double backgroundReserve)
+    : m_requestsPerMinute(std::max(1.0, requestsPerMinute)),
+      m_creditsPerMinute(std::max(1.0, creditsPerMinute)),
+      m_creditsPerDay(std::max(1.0, creditsPerDay)),
+      m_backgroundReserve(std::min(std::max(backgroundReserve, 0.0), 0.9)),
+      m_requestTokens(m_requestsPerMinute),
+      m_creditTokens(m_creditsPerMinute),
+      m_currentDay(CurrentUtcDay()),
+      m_lastRefill(Clock::now()) {
+}
+
+RateLimiter::Decision RateLimiter::TryAcquire(double credits, bool isBackground, Clock::duration& retryAfter) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Clock::time_point now = Clock::now();
+    Refill(now);
+
+    // Background work may not dip into the reserve kept for interactive requests
+    double reserve = isBackground ? m_backgroundReserve : 0.0;
+
+    if (m_creditsUsedToday + credits > m_creditsPerDay * (1.0 - reserve)) {
+        return Decision::Exhausted;
+    }
+
+    // Never ask for more than a full bucket, or small budgets would hold background work forever
+    double requestsNeeded = 1.0 + reserve * m_requestsPerMinute;
+    requestsNeeded = std::min(requestsNeeded, m_requestsPerMinute);
+    double creditsNeeded = std::min(credits, m_creditsPerMinute) + reserve * m_creditsPerMinute;
+    creditsNeeded = std::min(creditsNeeded, m_creditsPerMinute);
+
+    if (m_requestTokens < requestsNeeded || m_creditTokens < creditsNeeded) {
+        // Time until both buckets have refilled far enough
+        double requestSeconds = std::max(0.0, requestsNeeded - m_requestTokens) * 60.0 / m_requestsPerMinute;
+        double creditSeconds = std::max(0.0, creditsNeeded - m_creditTokens) * 60.0 / m_creditsPerMinute;
+        retryAfter = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(std::max(requestSeconds, creditSeconds)));
+        retryAfter = std::max(retryAfter, Clock::duration(std::chrono::milliseconds(10)));
+        return Decision::Wait;
+    }
+
+    m_requestTokens -= 1.0;
+    m_creditTokens -= credits;
+    m_creditsUsedToday += credits;
+    return Decision::Granted;
+}
+
+void RateLimiter::Refund(double credits) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Refill(Clock::now());
+
+    m_requestTokens = std::min(m_requestsPerMinute, m_requestTokens + 1.0);
+    m_creditTokens = std::min(m_creditsPerMinute, m_creditTokens + credits);
+    m_creditsUsedToday = std::max(0.0, m_creditsUsedToday - credits);
+}
+
+RateLimiterStats RateLimiter::GetStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Refill(Clock::now());
+
+    RateLimiterStats stats;
+    stats.requestsAvailable = std::max(0.0, m_requestTokens);
+    stats.creditsAvailable = std::max(0.0, m_creditTokens);
+    stats.creditsUsedToday = m_creditsUsedToday;
+    stats.creditsRemainingToday = std::max(0.0, m_creditsPerDay - m_creditsUsedToday);
+    return stats;
+}
+
+void RateLimiter::Refill(Clock::time_point now) {
+    double elapsedMinutes = std::chrono::duration<double>(now - m_lastRefill).count() / 60.0;
+    m_lastRefill = now;
+
+    m_requestTokens = std::min(m_requestsPerMinute, m_requestTokens + elapsedMinutes * m_requestsPerMinute);
+    m_creditTokens = std::min(m_creditsPerMinute, m_creditTokens + elapsedMinutes * m_creditsPerMinute);
+
+    long long today = CurrentUtcDay();
+    if (today != m_currentDay) {
+        m_currentDay = today;
+        m_creditsUsedToday = 0.0;
+    }
+}
@@ -0,0 +1,118 @@
+#include "ResponseCache.h"
+
+ResponseCache::ResponseCache(size_t maxBytes)
+    : m_maxBytes(maxBytes) {
+}
+
+ResponseCache::Body ResponseCache::Lookup(const std::string& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end() || Clock::now() >= it->second.expires) {
+        m_misses++;
+        return nullptr;
+    }
+
+    m_hits++;
+    Touch(it->second);
+    return it->second.body;
+}
+
+bool ResponseCache::IsFresh(const std::string& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    return it != m_entries.end() && Clock::now() < it->second.expires;
+}
+
+bool ResponseCache::GetValidators(const std::string& key, Validators& validators) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return false;
+    }
+
+    // An expired entry the server cannot revalidate is of no further use
+    if (it->second.validators.Empty()) {
+        Erase(it);
+        return false;
+    }
+
+    validators = it->second.validators;
+    return true;
+}
+
+ResponseCache::Body ResponseCache::Revalidate(const std::string& key, Clock::duration ttl) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return nullptr;
+    }
+
+    m_revalidated++;
+    it->second.expires = Clock::now() + ttl;
+    Touch(it->second);
+    return it->second.body;
+}
+
+ResponseCache::Body ResponseCache::Store(const std::string& key, std::string&& body, Validators validators,
+    Clock::duration ttl) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto existing = m_entries.find(key);
+    if (existing != m_entries.end()) {
+        Erase(existing);
+    }
+
+    // Bodies larger than the whole cache are not worth keeping
+    size_t size = EntrySize(key, body.size(), validators);
+    if (size > m_maxBytes) {
+        return nullptr;
+    }
+
+    Entry entry;
+    entry.body = std::make_shared<const std::string>(std::move(body));
+    entry.validators = std::move(validators);
+    entry.expires = Clock::now() + ttl;
+
+    // Make room, least recently used first
+    while (m_bytes + size > m_maxBytes && !m_lru.empty()) {
+        Erase(m_entries.find(m_lru.back()));
+    }
+
+    m_lru.push_front(key);
+    entry.lruPosition = m_lru.begin();
+    m_bytes += size;
+
+    Body stored = entry.body;
+    m_entries.emplace(key, std::move(entry));
+    return stored;
+}
+
+ResponseCache::Stats ResponseCache::GetStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.revalidated = m_revalidated;
+    stats.entries = m_entries.size();
+    stats.bytes = m_bytes;
+    return stats;
+}
+
+void ResponseCache::Touch(Entry& entry) {
+    m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+}
+
+void ResponseCache::Erase(std::unordered_map<std::string, Entry>::iterator it) {
+    m_bytes -= EntrySize(it->first, it->second.body->size(), it->second.validators);
+    m_lru.erase(it->second.lruPosition);
+    m_entries.erase(it);
+}
+
+size_t ResponseCache::EntrySize(const std::string& key, size_t bodySize, const Validators& validators) {
+    return key.size() + bodySize + validators.etag.size() + validators.lastModified.size();
+}
@@ -1,8 +1,11 @@
 #include "TradingUI.h"
 #include "implot.h"
 #include "CryptoAPIClient.h"
+#include "MarketFeed.h"
 #include "Config.h"
+#include <algorithm>
 #include <string>
+#include <vector>
 #include <iomanip>
 #include <sstream>
 
@@ -29,6 +32,11 @@ void TradingUI::Initialize() {
     m_positionsPanel.Initialize(m_boldFont, m_defaultFont);
     m_tradingPanel.Initialize(m_boldFont, m_mediumFont);
 
+    // Quotes the chart fetches go through the market state like any other
+    m_chartPanel.SetQuoteCallback([this](const PriceData& data, bool isRealData) {
+        OnQuote(data, isRealData);
+        });
+
     // Set up trading callback
     m_tradingPanel.SetTradeCallback([this](bool isBuy, const std::string& symbol,
         double price, double amount) {
@@ -83,6 +91,9 @@ void TradingUI::SetupStyle() {
 }
 
 void TradingUI::Render() {
+    // Bring prices up to date before drawing
+    ApplyMarketSnapshot();
+
     // Render menu bar
     RenderMenuBar();
 
@@ -227,6 +238,42 @@ void TradingUI::RenderMenuBar() {
             ImGui::EndMenu();
         }
 
+        if (ImGui::BeginMenu("API")) {
+            if (m_apiClient) {
+                APIMetrics metrics = m_apiClient->GetMetrics();
+                ImGui::Text("Credits left today: %.0f (used %.0f)", metrics.creditsRemainingToday, metrics.creditsUsedToday);
+                ImGui::Text("Credits left this minute: %.0f", metrics.creditsAvailable);
+                ImGui::Text("Requests available: %.0f", metrics.requestsAvailable);
+                ImGui::Separator();
+                ImGui::Text("Requests sent: %llu", static_cast<unsigned long long>(metrics.requestsSent));
+                ImGui::Text("Deferred by rate limit: %llu", static_cast<unsigned long long>(metrics.requestsDeferred));
+                ImGui::Text("Rejected (no credits): %llu", static_cast<unsigned long long>(metrics.requestsRejected));
+                ImGui::Text("Retried: %llu", static_cast<unsigned long long>(metrics.requestsRetried));
+                ImGui::Text("Failed fast (circuit open): %llu", static_cast<unsigned long long>(metrics.requestsShortCircuited));
+                if (metrics.openCircuits > 0) {
+                    ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "Endpoints suspended: %d", metrics.openCircuits);
+                }
+                if (m_marketFeed) {
+                    MarketFeedStats feedStats = m_marketFeed->GetStats();
+                    ImGui::Separator();
+                    ImGui::Text("Price feed: %s", feedStats.live ? "live" : "offline (polling)");
+                    ImGui::Text("Feed ticks: %llu (gaps %llu, reconnects %llu)",
+                        static_cast<unsigned long long>(feedStats.ticks),
+                        static_cast<unsigned long long>(feedStats.gaps),
+                        static_cast<unsigned long long>(feedStats.reconnects));
+                }
+                ImGui::Separator();
+                ImGui::Text("Cache hits: %llu (revalidated %llu)", static_cast<unsigned long long>(metrics.cacheHits),
+                    static_cast<unsigned long long>(metrics.cacheRevalidated));
+                ImGui::Text("Cache misses: %llu", static_cast<unsigned long long>(metrics.cacheMisses));
+                ImGui::Text("Cache size: %.1f MB", metrics.cacheBytes / (1024.0 * 1024.0));
+            }
+            else {
+                ImGui::TextDisabled("API client not initialized");
+            }
+            ImGui::EndMenu();
+        }
+
         if (ImGui::BeginMenu("Demo")) {
             ImGui::MenuItem("ImGui Demo", nullptr, &m_menuState.showDemo);
             ImGui::EndMenu();
@@ -247,6 +294,53 @@ void TradingUI::SetAPIClient(std::shared_ptr<CryptoAPIClient> apiClient) {
     m_chartPanel.SetAPIClient(apiClient);
 }
 
+void TradingUI::SetMarketFeed(std::shared_ptr<MarketFeed> marketFeed) {
+    m_marketFeed = marketFeed;
+    if (m_marketFeed) {
+        m_marketFeed->Start([this](const PriceData& data) {
+            OnQuote(data, true);
+            });
+    }
+}
+
+void TradingUI::OnQuote(const PriceData& data, bool isRealData) {
+    // Candles need every tick, not just the latest; mock prices would leave made-up ones behind
+    if (isRealData) {
+        m_chartPanel.AddTick(data);
+    }
+
+    m_marketState.Publish(data, isRealData);
+}
+
+void TradingUI::ApplyMarketSnapshot() {
+    const MarketSnapshot& snapshot = m_marketState.Acquire();
+    InstrumentId charted = m_chartPanel.GetInstrument();
+    if (snapshot.version == m_appliedVersion && charted == m_chartedInstrument) {
+        return;
+    }
+
+    // A newly charted instrument shows the last quote it had straight away
+    if (charted != m_chartedInstrument && charted < snapshot.quotes.size() &&
+        snapshot.quotes[charted].sequence != 0 && snapshot.quotes[charted].sequence <= m_appliedVersion) {
+        m_chartPanel.ApplyQuote(charted, snapshot.quotes[charted]);
+    }
+    m_chartedInstrument = charted;
+
+    for (size_t i = 0; i < snapshot.quotes.size(); i++) {
+        const MarketQuote& quote = snapshot.quotes[i];
+        if (quote.sequence <= m_appliedVersion) {
+            continue;
+        }
+
+        // Mark every position in this instrument to market, and the chart if it is the charted one
+        InstrumentId instrument = static_cast<InstrumentId>(i);
+        m_positionsPanel.UpdatePositionPrice(instrument, quote.price);
+        m_chartPanel.ApplyQuote(instrument, quote);
+    }
+
+    m_appliedVersion = snapshot.version;
+}
+
 void TradingUI::UpdatePriceData() {
     if (!m_apiClient) {
         return;
@@ -255,20 +349,31 @@ void TradingUI::UpdatePriceData() {
     // Get current symbol
     std::string symbol = m_chartPanel.GetSymbol();
 
-    // Update chart data
-    m_chartPanel.UpdateChartData(symbol);
+    // Update chart history; its price comes from the batched quotes below.
+    // Timer refreshes queue behind anything the user asked for
+    m_chartPanel.UpdateChartData(symbol, false, RequestPriority::Background);
 
-    // Update positions with new prices
-    m_apiClient->FetchLatestQuote(symbol, [this, symbol](const PriceData& data, bool isRealData) {
-        // Update positions with new price data
-        m_positionsPanel.UpdatePositionPrice(symbol, data.price);
+    // Coalesce every listed symbol and every symbol with an open position into one request
+    std::vector<std::string> symbols(Config::UI::AVAILABLE_CRYPTOS,
+        Config::UI::AVAILABLE_CRYPTOS + Config::UI::AVAILABLE_CRYPTOS_COUNT);
+    for (const auto& position : m_positionsPanel.GetPositions()) {
+        if (position.isOpen && std::find(symbols.begin(), symbols.end(), position.symbol) == symbols.end()) {
+            symbols.push_back(position.symbol);
+        }
+    }
 
-        // Check for balance changes from positions
-        double pnl = m_positionsPanel.GetTotalProfitLoss();
+    // The feed pushes these prices as they change; poll only while it is down
+    if (m_marketFeed) {
+        m_marketFeed->SetSymbols(symbols);
+        if (m_marketFeed->IsLive()) {
+            return;
+        }
+    }
 
-        // Update menu balance (just for display - actual updates happen on trade execution/closing)
-        // This is just to reflect unrealized P&L if needed
-        });
+    // Positions and the chart pick the quotes up on the next frame
+    m_apiClient->FetchLatestQuotes(symbols, [this](const PriceData& data, bool isRealData) {
+        OnQuote(data, isRealData);
+        }, RequestPriority::Background);
 }
 
 void TradingUI::ExecuteTrade(bool isBuy, const std::string& symbol, double price, double amount) {
@@ -283,6 +388,7 @@ void TradingUI::ExecuteTrade(bool isBuy, const std::string& symbol, double price
     // Create position
     Position newPosition;
     newPosition.symbol = symbol;
+    newPosition.instrument = InstrumentRegistry::Instance().Intern(symbol);
     newPosition.type = isBuy ? "Long" : "Short";
     newPosition.entryPrice = price;
     newPosition.amount = amount;
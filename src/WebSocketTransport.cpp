@@ -0,0 +1,15 @@
+#include "WebSocketTransport.h"
+
+#ifdef _WIN32
+#include "WinHttpWebSocket.h"
+#else
+#include "PosixWebSocket.h"
+#endif
+
+std::unique_ptr<IWebSocketConnection> CreateWebSocketConnection() {
+#ifdef _WIN32
+    return std::make_unique<WinHttpWebSocket>();
+#else
+    return std::make_unique<PosixWebSocket>();
+#endif
+}
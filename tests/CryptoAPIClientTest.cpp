@@ -0,0 +1,114 @@
+// Request pipeline checks that need a request stopped between two steps of a worker, which
+// the threads never do on cue. The client is left uninitialized, so no threads run, and
+// each check walks a request through TakeRunnable and ExecuteRequest itself.
+//
+//     CryptoAPIClientTest
+//
+// Exits non-zero if any check fails.
+#include "CryptoAPIClient.h"
+#include "Config.h"
+#include <cstdio>
+
+namespace {
+    int g_failures = 0;
+
+    void Check(bool condition, const char* what) {
+        printf("  %s  %s\n", condition ? "ok  " : "FAIL", what);
+        if (!condition) {
+            g_failures++;
+        }
+    }
+
+    // Counts the requests that reached the server
+    class CountingTransport : public IHttpTransport {
+    public:
+        explicit CountingTransport(int& requests) : m_requests(requests) {
+        }
+
+        bool Get(const std::string&, const std::map<std::string, std::string>&,
+            HttpResponse& response, std::string&) override {
+            m_requests++;
+            response.statusCode = 200;
+            response.body = "{}";
+            return true;
+        }
+
+    private:
+        int& m_requests;
+    };
+}
+
+class CryptoAPIClientTest {
+public:
+    // A half-open breaker admits one probe. If another worker caches the response before the
+    // probe is sent, the probe is answered from the cache and never reports an outcome; it
+    // must hand back the probe and its rate-limit budget, or the endpoint stays shut
+    static void ProbeAnsweredFromCache() {
+        printf("half-open probe answered from the cache\n");
+
+        int sent = 0;
+        CryptoAPIClient client;
+        client.SetTransport(std::make_unique<CountingTransport>(sent));
+        client.m_rateLimiter = std::make_unique<RateLimiter>(30.0, 1000.0, 10000.0, 0.0);
+
+        const std::string endpoint = "/v2/cryptocurrency/quotes/latest";
+        const std::map<std::string, std::string> params = { { "symbol", "ETH" } };
+        const std::string key = CryptoAPIClient::MakeRequestKey(endpoint, params);
+
+        // Trip the breaker long enough ago that its open period is over
+        CircuitBreaker::Clock::time_point now = CircuitBreaker::Clock::now();
+        CircuitBreaker& breaker = client.GetBreaker(endpoint);
+        for (int i = 0; i < Config::API::CIRCUIT_FAILURE_THRESHOLD; i++) {
+            breaker.RecordFailure(now - std::chrono::seconds(Config::API::CIRCUIT_MAX_OPEN_SECONDS + 1));
+        }
+        Check(breaker.GetState() == CircuitBreaker::State::Open, "breaker opened");
+
+        double requestsBefore = client.m_rateLimiter->GetStats().requestsAvailable;
+        double creditsBefore = client.m_rateLimiter->GetStats().creditsUsedToday;
+
+        CryptoAPIClient::APIRequest queued;
+        queued.priority = RequestPriority::Interactive;
+        queued.endpoint = endpoint;
+        queued.params = params;
+        queued.cacheKey = key;
+        queued.credits = 1.0;
+        std::string delivered;
+        queued.callback = [&delivered](std::string_view body) { delivered = body; };
+        client.m_readyRequests[static_cast<size_t>(queued.priority)].push_back(std::move(queued));
+
+        // The dispatcher admits the request as the probe
+        CryptoAPIClient::APIRequest request;
+        RateLimiter::Clock::duration retryAfter = RateLimiter::Clock::duration::max();
+        Check(client.TakeRunnable(request, retryAfter), "request taken");
+        Check(request.admitted && request.probe, "request admitted as the probe");
+        Check(breaker.GetState() == CircuitBreaker::State::HalfOpen, "breaker half-open");
+
+        // Another worker's response lands in the cache before this one is sent
+        client.m_responseCache.Store(key, std::string("{\"cached\":true}"), {},
+            std::chrono::seconds(Config::API::QUOTE_CACHE_TTL));
+
+        Check(!client.ExecuteRequest(request), "request finished");
+        Check(delivered == "{\"cached\":true}", "caller got the cached response");
+        Check(sent == 0, "nothing sent to the server");
+
+        // The next request to the endpoint gets the probe
+        CircuitBreaker::Clock::duration wait;
+        Check(breaker.Admit(CircuitBreaker::Clock::now(), wait) == CircuitBreaker::Admission::Allow,
+            "probe handed back");
+
+        RateLimiterStats stats = client.m_rateLimiter->GetStats();
+        Check(stats.requestsAvailable >= requestsBefore - 1e-6, "request token refunded");
+        Check(stats.creditsUsedToday <= creditsBefore + 1e-6, "credits refunded");
+    }
+};
+
+int main() {
+    CryptoAPIClientTest::ProbeAnsweredFromCache();
+
+    if (g_failures > 0) {
+        printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
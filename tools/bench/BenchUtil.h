@@ -0,0 +1,72 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Timing helpers shared by the benchmarks in tools/bench
+namespace Bench {
+    using Clock = std::chrono::steady_clock;
+
+    inline double ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Median wall time of one call of fn, in milliseconds, over iterations calls after a warm-up
+    template <typename Fn>
+    double MedianMs(int iterations, Fn&& fn) {
+        fn();
+
+        std::vector<double> times;
+        times.reserve(iterations);
+        for (int i = 0; i < iterations; i++) {
+            Clock::time_point start = Clock::now();
+            fn();
+            times.push_back(ElapsedMs(start));
+        }
+
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+
+    // listings/latest-shaped body with rows ranked by market cap: BTC, ETH, then C2, C3, ...
+    inline std::string MakeListingsResponse(size_t rows) {
+        nlohmann::json body;
+        body["status"] = { {"timestamp", "2024-01-01T00:00:00.000Z"}, {"error_code", 0},
+            {"error_message", nullptr}, {"elapsed", 12}, {"credit_count", 25} };
+
+        nlohmann::json data = nlohmann::json::array();
+        for (size_t i = 0; i < rows; i++) {
+            std::string symbol = i == 0 ? "BTC" : i == 1 ? "ETH" : "C" + std::to_string(i);
+            double price = 50000.0 / static_cast<double>(i + 1);
+
+            nlohmann::json usd = { {"price", price}, {"volume_24h", price * 1.0e6},
+                {"volume_change_24h", 1.5}, {"percent_change_1h", 0.1}, {"percent_change_24h", -2.3},
+                {"percent_change_7d", 4.2}, {"market_cap", price * 2.0e7}, {"market_cap_dominance", 0.5},
+                {"fully_diluted_market_cap", price * 2.1e7}, {"last_updated", "2024-01-01T00:00:00.000Z"} };
+
+            data.push_back({ {"id", i + 1}, {"name", "Coin " + std::to_string(i)}, {"symbol", symbol},
+                {"slug", "coin-" + std::to_string(i)}, {"num_market_pairs", 100 + i},
+                {"date_added", "2015-01-01T00:00:00.000Z"}, {"tags", {"mineable", "pow", "store-of-value"}},
+                {"max_supply", nullptr}, {"circulating_supply", 1.0e7}, {"total_supply", 1.0e7},
+                {"platform", nullptr}, {"cmc_rank", i + 1}, {"last_updated", "2024-01-01T00:00:00.000Z"},
+                {"quote", { {"USD", usd} }} });
+        }
+        body["data"] = std::move(data);
+        return body.dump();
+    }
+
+    // Whole file as a string; empty if it can't be read
+    inline std::string ReadFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+}
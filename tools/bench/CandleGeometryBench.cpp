@@ -0,0 +1,137 @@
+// Time to map a frame's candlesticks to pixels: CandleGeometry::Build over the columns
+// against the old per-bar path, which converted six points per bar one call at a time.
+//
+//     CandleGeometryBench [bars ...]
+//
+// Only the mapping is timed; emitting the geometry into an ImGui draw list needs a UI
+// context and is left to the application. The per-bar path stands in for
+// ImPlot::PlotToPixels with an out-of-line call that reads the current plot's axes
+// for every point, as ImPlot does. Defaults to 100, 10k and 1M bars.
+#include "BenchUtil.h"
+#include "CandleGeometry.h"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+namespace {
+    struct Axis {
+        double plotMin = 0.0;
+        double plotMax = 1.0;
+        float pixelMin = 0.0f;
+        float pixelMax = 1.0f;
+    };
+
+    // The state PlotToPixels reads on every call
+    struct Plot {
+        Axis x;
+        Axis y;
+    };
+
+    struct Point {
+        float x;
+        float y;
+    };
+
+    Plot* g_currentPlot = nullptr;
+
+#if defined(_MSC_VER)
+    __declspec(noinline)
+#else
+    __attribute__((noinline))
+#endif
+    Point PlotToPixels(double x, double y) {
+        const Plot& plot = *g_currentPlot;
+        double scaleX = (plot.x.pixelMax - plot.x.pixelMin) / (plot.x.plotMax - plot.x.plotMin);
+        double scaleY = (plot.y.pixelMax - plot.y.pixelMin) / (plot.y.plotMax - plot.y.plotMin);
+        return { static_cast<float>(plot.x.pixelMin + scaleX * (x - plot.x.plotMin)),
+            static_cast<float>(plot.y.pixelMin + scaleY * (y - plot.y.plotMin)) };
+    }
+
+    // The six points the old DrawCandlestick converted for each bar
+    void MapPerBar(const OhlcvColumns& columns, double width, std::vector<Point>& points) {
+        points.resize(columns.count * 6);
+        Point* out = points.data();
+        for (size_t i = 0; i < columns.count; i++) {
+            double x = columns.timestamps[i];
+            *out++ = PlotToPixels(x, columns.lows[i]);
+            *out++ = PlotToPixels(x, columns.highs[i]);
+            *out++ = PlotToPixels(x - width / 2.0, columns.opens[i]);
+            *out++ = PlotToPixels(x + width / 2.0, columns.opens[i]);
+            *out++ = PlotToPixels(x - width / 2.0, columns.closes[i]);
+            *out++ = PlotToPixels(x + width / 2.0, columns.closes[i]);
+        }
+    }
+
+    // A random walk of minute bars
+    struct Bars {
+        std::vector<double> timestamps, opens, highs, lows, closes, volumes;
+
+        OhlcvColumns Columns() const {
+            return { timestamps.data(), opens.data(), highs.data(), lows.data(), closes.data(),
+                volumes.data(), timestamps.size() };
+        }
+    };
+
+    Bars MakeBars(size_t count) {
+        std::mt19937 random(7);
+        std::normal_distribution<double> step(0.0, 1.0);
+        Bars bars;
+        double close = 2500.0;
+        for (size_t i = 0; i < count; i++) {
+            double open = close;
+            close = open + step(random);
+            bars.timestamps.push_back(1.7e9 + 60.0 * i);
+            bars.opens.push_back(open);
+            bars.closes.push_back(close);
+            bars.highs.push_back(std::max(open, close) + std::abs(step(random)));
+            bars.lows.push_back(std::min(open, close) - std::abs(step(random)));
+            bars.volumes.push_back(1.0);
+        }
+        return bars;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; i++) {
+        counts.push_back(static_cast<size_t>(std::atoll(argv[i])));
+    }
+    if (counts.empty()) {
+        counts = { 100, 10000, 1000000 };
+    }
+
+    printf("bars mapped to pixels per frame, milliseconds\n");
+    printf("  %9s   %10s   %10s\n", "bars", "per-bar", "Build");
+    for (size_t count : counts) {
+        if (count < 2) {
+            continue;
+        }
+        Bars bars = MakeBars(count);
+        OhlcvColumns columns = bars.Columns();
+        double width = 0.6 * 60.0;
+
+        // A 1600x900 plot showing every bar
+        Plot plot;
+        plot.x = { columns.timestamps[0], columns.timestamps[count - 1], 0.0f, 1600.0f };
+        plot.y = { *std::min_element(bars.lows.begin(), bars.lows.end()),
+            *std::max_element(bars.highs.begin(), bars.highs.end()), 900.0f, 0.0f };
+        g_currentPlot = &plot;
+
+        PlotTransform transform;
+        transform.scaleX = (plot.x.pixelMax - plot.x.pixelMin) / (plot.x.plotMax - plot.x.plotMin);
+        transform.scaleY = (plot.y.pixelMax - plot.y.pixelMin) / (plot.y.plotMax - plot.y.plotMin);
+        transform.originX = plot.x.pixelMin - plot.x.plotMin * transform.scaleX;
+        transform.originY = plot.y.pixelMin - plot.y.plotMin * transform.scaleY;
+
+        int iterations = count >= 1000000 ? 11 : 101;
+        std::vector<Point> points;
+        double perBarMs = Bench::MedianMs(iterations, [&]() { MapPerBar(columns, width, points); });
+
+        CandleGeometry geometry;
+        double buildMs = Bench::MedianMs(iterations, [&]() { geometry.Build(columns, 0, count, width, transform); });
+
+        printf("  %9zu   %10.4f   %10.4f\n", count, perBarMs, buildMs);
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Per-tick cost of bringing the chart up to date with the candles: the old path, which
+// copied the candles out into a new BarSeries, converted its timestamps to the plot's
+// time axis and rebuilt the whole pyramid, against drawing the aggregator's columns in
+// place and updating the pyramid from the last bar shown.
+//
+//     ChartRefreshBench [ticks] [capacities ...]
+//
+// Ticks arrive a few seconds apart, so most update the open minute candle and some open
+// the next one. Only the 1m candles are refreshed, as the chart does for the interval on
+// screen. Defaults to 20000 ticks at 1440 (a day of minute bars), 10k and 100k candles.
+#include "BenchUtil.h"
+#include "BarSeries.h"
+#include "CandleAggregator.h"
+#include "OhlcPyramid.h"
+#include <cstdlib>
+#include <random>
+
+namespace {
+    struct Tick {
+        double timestamp;
+        double price;
+    };
+
+    std::vector<Tick> MakeTicks(size_t count, double start) {
+        std::mt19937 random(3);
+        std::uniform_int_distribution<int> gap(1, 10);
+        std::normal_distribution<double> step(0.0, 0.5);
+        std::vector<Tick> ticks;
+        double timestamp = start;
+        double price = 2500.0;
+        for (size_t i = 0; i < count; i++) {
+            timestamp += gap(random);
+            price = std::max(1.0, price + step(random));
+            ticks.push_back({ timestamp, price });
+        }
+        return ticks;
+    }
+
+    // The old refresh: a BarSeries copy of the candles, its time axis, and a full build
+    void RefreshByCopy(const OhlcvColumns& candles, std::vector<double>& timeAxis, OhlcPyramid& pyramid) {
+        auto series = std::make_shared<BarSeries>();
+        series->Reserve(candles.count);
+        for (size_t i = 0; i < candles.count; i++) {
+            series->Append(static_cast<int64_t>(candles.timestamps[i]), candles.opens[i], candles.highs[i],
+                candles.lows[i], candles.closes[i], candles.volumes[i]);
+        }
+        timeAxis.assign(series->GetTimestamps().begin(), series->GetTimestamps().end());
+
+        OhlcvSpans bars;
+        bars.head.timestamps = timeAxis.data();
+        bars.head.opens = series->GetOpens().data();
+        bars.head.highs = series->GetHighs().data();
+        bars.head.lows = series->GetLows().data();
+        bars.head.closes = series->GetCloses().data();
+        bars.head.volumes = series->GetVolumes().data();
+        bars.head.count = series->Size();
+        pyramid.Build(bars);
+    }
+
+    void RunCase(size_t capacity, size_t tickCount) {
+        InstrumentId instrument = InstrumentRegistry::Instance().Intern("BENCH");
+
+        // Fill the candles first, so every refresh sees at least capacity of them
+        double start = 1.7e9;
+        CandleAggregator candles(capacity);
+        for (size_t i = 0; i < capacity; i++) {
+            candles.AddTick(instrument, start, 2500.0);
+            start += 60.0;
+        }
+        std::vector<Tick> ticks = MakeTicks(tickCount, start);
+
+        std::vector<double> timeAxis;
+        OhlcPyramid copied;
+        double copyMs = Bench::MedianMs(3, [&]() {
+            CandleAggregator run = candles;
+            for (const Tick& tick : ticks) {
+                run.AddTick(instrument, tick.timestamp, tick.price);
+                RefreshByCopy(run.GetCandles(instrument, CandleInterval::OneMinute), timeAxis, copied);
+            }
+        });
+
+        OhlcPyramid updated;
+        double updateMs = Bench::MedianMs(3, [&]() {
+            CandleAggregator run = candles;
+            size_t shownCount = 0;
+            uint64_t shownLayout = run.GetLayout(instrument);
+            for (const Tick& tick : ticks) {
+                run.AddTick(instrument, tick.timestamp, tick.price);
+                OhlcvSpans bars;
+                bars.head = run.GetCandles(instrument, CandleInterval::OneMinute);
+                uint64_t layout = run.GetLayout(instrument);
+                updated.Update(bars, layout == shownLayout && shownCount > 0 ? shownCount - 1 : 0);
+                shownCount = bars.Count();
+                shownLayout = layout;
+            }
+        });
+
+        printf("  %9zu   %12.2f   %12.3f\n", capacity, copyMs * 1e3 / ticks.size(), updateMs * 1e3 / ticks.size());
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t ticks = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 20000;
+    std::vector<size_t> capacities;
+    for (int i = 2; i < argc; i++) {
+        capacities.push_back(static_cast<size_t>(std::atoll(argv[i])));
+    }
+    if (capacities.empty()) {
+        capacities = { 1440, 10000, 100000 };
+    }
+    if (ticks == 0) {
+        fprintf(stderr, "ticks must be positive\n");
+        return 1;
+    }
+
+    printf("%zu ticks; microseconds per tick to refresh the 1m chart\n", ticks);
+    printf("  %9s   %12s   %12s\n", "candles", "copy+build", "in place");
+    for (size_t capacity : capacities) {
+        if (capacity > 0) {
+            RunCase(capacity, ticks);
+        }
+    }
+    return 0;
+}
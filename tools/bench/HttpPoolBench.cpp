@@ -0,0 +1,190 @@
+// Sequential request latency through the HTTP transport, reusing pooled keep-alive
+// connections against opening a fresh connection for every request (what
+// SimpleHttpClient::Get used to do).
+//
+//     HttpPoolBench [requests] [body_bytes] [handshake_ms]
+//     HttpPoolBench --url http://host:port/path [requests]
+//
+// By default the requests go to a plain-HTTP server started in-process on loopback.
+// handshake_ms makes that server stall every new connection before it answers, to stand
+// in for the TCP+TLS round trips a real API host costs per connection.
+#include "BenchUtil.h"
+#include "PosixHttpTransport.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+    // Keep-alive HTTP/1.1 server answering every GET with the same body
+    class LoopbackServer {
+    public:
+        LoopbackServer(size_t bodyBytes, int handshakeMs)
+            : m_body(bodyBytes, 'x'), m_handshakeMs(handshakeMs) {
+            m_listener = socket(AF_INET, SOCK_STREAM, 0);
+            int enable = 1;
+            setsockopt(m_listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            bind(m_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+            listen(m_listener, 64);
+
+            socklen_t length = sizeof(address);
+            getsockname(m_listener, reinterpret_cast<sockaddr*>(&address), &length);
+            m_port = ntohs(address.sin_port);
+
+            m_acceptThread = std::thread(&LoopbackServer::AcceptLoop, this);
+        }
+
+        ~LoopbackServer() {
+            m_running = false;
+            shutdown(m_listener, SHUT_RDWR);
+            close(m_listener);
+            m_acceptThread.join();
+        }
+
+        int GetPort() const { return m_port; }
+        size_t GetConnectionCount() const { return m_connections; }
+
+    private:
+        void AcceptLoop() {
+            while (m_running) {
+                int client = accept(m_listener, nullptr, nullptr);
+                if (client < 0) {
+                    return;
+                }
+                m_connections++;
+                std::thread(&LoopbackServer::Serve, this, client).detach();
+            }
+        }
+
+        void Serve(int client) {
+            if (m_handshakeMs > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(m_handshakeMs));
+            }
+
+            // Head and body go out in one send, so Nagle never holds back the tail
+            std::string reply = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                std::to_string(m_body.size()) + "\r\n\r\n" + m_body;
+            std::string pending;
+            char chunk[4096];
+            while (true) {
+                ssize_t received = recv(client, chunk, sizeof(chunk), 0);
+                if (received <= 0) {
+                    break;
+                }
+                pending.append(chunk, static_cast<size_t>(received));
+
+                // Answer every complete request head received so far
+                size_t end;
+                while ((end = pending.find("\r\n\r\n")) != std::string::npos) {
+                    pending.erase(0, end + 4);
+                    SendAll(client, reply);
+                }
+            }
+            close(client);
+        }
+
+        static void SendAll(int client, const std::string& data) {
+            size_t sent = 0;
+            while (sent < data.size()) {
+                ssize_t written = send(client, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                if (written <= 0) {
+                    return;
+                }
+                sent += static_cast<size_t>(written);
+            }
+        }
+
+        std::string m_body;
+        int m_handshakeMs;
+        int m_listener = -1;
+        int m_port = 0;
+        std::atomic<bool> m_running{ true };
+        std::atomic<size_t> m_connections{ 0 };
+        std::thread m_acceptThread;
+    };
+
+    struct LatencyResult {
+        double medianMs = 0.0;
+        double totalMs = 0.0;
+        int failures = 0;
+    };
+
+    // Send requests one after another; fresh gives every request its own transport, and so
+    // its own connection, torn down afterwards
+    LatencyResult Run(const std::string& url, int requests, bool fresh) {
+        LatencyResult result;
+        PosixHttpTransport pooled(8, 60, 10);
+        HttpResponse response;
+        std::string error;
+
+        std::vector<double> times;
+        Bench::Clock::time_point runStart = Bench::Clock::now();
+        for (int i = 0; i < requests; i++) {
+            Bench::Clock::time_point start = Bench::Clock::now();
+            bool ok;
+            if (fresh) {
+                PosixHttpTransport transport(8, 60, 10);
+                ok = transport.Get(url, {}, response, error);
+            }
+            else {
+                ok = pooled.Get(url, {}, response, error);
+            }
+            times.push_back(Bench::ElapsedMs(start));
+
+            if (!ok || response.statusCode != 200) {
+                result.failures++;
+            }
+        }
+        result.totalMs = Bench::ElapsedMs(runStart);
+
+        std::sort(times.begin(), times.end());
+        result.medianMs = times.empty() ? 0.0 : times[times.size() / 2];
+        return result;
+    }
+
+    void Report(const char* label, const LatencyResult& result, int requests) {
+        printf("  %-8s median %7.3f ms  total %9.1f ms  %5.0f req/s  failures %d\n", label,
+            result.medianMs, result.totalMs, requests * 1000.0 / result.totalMs, result.failures);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && std::strcmp(argv[1], "--url") == 0) {
+        std::string url = argv[2];
+        int requests = argc > 3 ? std::atoi(argv[3]) : 50;
+
+        printf("%d sequential GETs to %s\n", requests, url.c_str());
+        Report("fresh", Run(url, requests, true), requests);
+        Report("pooled", Run(url, requests, false), requests);
+        return 0;
+    }
+
+    int requests = argc > 1 ? std::atoi(argv[1]) : 1000;
+    size_t bodyBytes = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 16 * 1024;
+    int handshakeMs = argc > 3 ? std::atoi(argv[3]) : 0;
+    if (requests <= 0) {
+        fprintf(stderr, "requests must be positive\n");
+        return 1;
+    }
+
+    LoopbackServer server(bodyBytes, handshakeMs);
+    std::string url = "http://127.0.0.1:" + std::to_string(server.GetPort()) + "/v1/cryptocurrency/quotes/latest";
+
+    printf("%d sequential GETs, %zu byte body, %d ms per new connection\n", requests, bodyBytes, handshakeMs);
+    size_t before = server.GetConnectionCount();
+    Report("fresh", Run(url, requests, true), requests);
+    printf("           %zu connections opened\n", server.GetConnectionCount() - before);
+
+    before = server.GetConnectionCount();
+    Report("pooled", Run(url, requests, false), requests);
+    printf("           %zu connections opened\n", server.GetConnectionCount() - before);
+    return 0;
+}
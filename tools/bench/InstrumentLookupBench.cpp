@@ -0,0 +1,155 @@
+// Per-tick cost of applying a price update to the open positions and the latest-quote
+// table, keyed by symbol string (the old paths) against keyed by interned InstrumentId.
+//
+//     InstrumentLookupBench [ticks] [symbols]
+//
+// Ticks are spread at random over the symbols, and positions over the same symbols. The
+// string paths are the ones PositionsPanel and the quote cache used before instrument
+// ids: a scan comparing every position's symbol, and a hash map keyed by symbol. The id
+// paths look the tick's symbol up once where it enters (Find) and then index flat
+// arrays, or start from an id the feed already carries.
+#include "BenchUtil.h"
+#include "InstrumentRegistry.h"
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+
+namespace {
+    // The fields the per-tick update touches
+    struct Position {
+        std::string symbol;
+        InstrumentId instrument = INVALID_INSTRUMENT;
+        bool isLong = true;
+        double entryPrice = 100.0;
+        double amount = 1.0;
+        double currentPrice = 0.0;
+        double profitLoss = 0.0;
+    };
+
+    struct Quote {
+        double price = 0.0;
+        uint64_t sequence = 0;
+    };
+
+    void Reprice(Position& position, double price) {
+        position.currentPrice = price;
+        double priceChange = price - position.entryPrice;
+        position.profitLoss = (position.isLong ? priceChange : -priceChange) * position.amount;
+    }
+
+    struct Tick {
+        std::string symbol;
+        InstrumentId instrument;
+        double price;
+    };
+
+    struct Workload {
+        std::vector<Position> positions;
+        std::vector<Tick> ticks;
+    };
+
+    Workload MakeWorkload(size_t positionCount, size_t symbolCount, size_t tickCount) {
+        std::mt19937 random(42);
+        std::uniform_int_distribution<size_t> pickSymbol(0, symbolCount - 1);
+        std::uniform_real_distribution<double> pickPrice(50.0, 150.0);
+        InstrumentRegistry& registry = InstrumentRegistry::Instance();
+
+        Workload workload;
+        for (size_t i = 0; i < positionCount; i++) {
+            Position position;
+            position.symbol = "SYM" + std::to_string(pickSymbol(random));
+            position.instrument = registry.Intern(position.symbol);
+            position.isLong = i % 2 == 0;
+            workload.positions.push_back(position);
+        }
+        for (size_t i = 0; i < tickCount; i++) {
+            std::string symbol = "SYM" + std::to_string(pickSymbol(random));
+            InstrumentId instrument = registry.Intern(symbol);
+            workload.ticks.push_back({ symbol, instrument, pickPrice(random) });
+        }
+        return workload;
+    }
+
+    // Nanoseconds per tick of fn(tick) over every tick
+    template <typename Fn>
+    double PerTickNs(const std::vector<Tick>& ticks, Fn&& fn) {
+        double ms = Bench::MedianMs(5, [&]() {
+            for (const auto& tick : ticks) {
+                fn(tick);
+            }
+        });
+        return ms * 1e6 / ticks.size();
+    }
+
+    void RunCase(size_t positionCount, size_t symbolCount, size_t tickCount) {
+        Workload workload = MakeWorkload(positionCount, symbolCount, tickCount);
+        std::vector<Position>& positions = workload.positions;
+        uint64_t sequence = 0;
+
+        // Symbol strings: every position compared, quotes in a map keyed by symbol
+        std::unordered_map<std::string, Quote> quotesBySymbol;
+        double scanNs = PerTickNs(workload.ticks, [&](const Tick& tick) {
+            for (auto& position : positions) {
+                if (position.symbol == tick.symbol) {
+                    Reprice(position, tick.price);
+                }
+            }
+            quotesBySymbol[tick.symbol] = { tick.price, ++sequence };
+        });
+
+        // Symbol strings, but positions grouped per symbol in a hash map
+        std::unordered_map<std::string, std::vector<size_t>> positionsBySymbol;
+        for (size_t i = 0; i < positions.size(); i++) {
+            positionsBySymbol[positions[i].symbol].push_back(i);
+        }
+        double hashNs = PerTickNs(workload.ticks, [&](const Tick& tick) {
+            auto found = positionsBySymbol.find(tick.symbol);
+            if (found != positionsBySymbol.end()) {
+                for (size_t index : found->second) {
+                    Reprice(positions[index], tick.price);
+                }
+            }
+            quotesBySymbol[tick.symbol] = { tick.price, ++sequence };
+        });
+
+        // Instrument ids: positions and quotes in flat arrays indexed by id
+        InstrumentRegistry& registry = InstrumentRegistry::Instance();
+        std::vector<std::vector<size_t>> positionsById(registry.Size());
+        for (size_t i = 0; i < positions.size(); i++) {
+            positionsById[positions[i].instrument].push_back(i);
+        }
+        std::vector<Quote> quotesById(registry.Size());
+        auto applyById = [&](InstrumentId instrument, double price) {
+            for (size_t index : positionsById[instrument]) {
+                Reprice(positions[index], price);
+            }
+            quotesById[instrument] = { price, ++sequence };
+        };
+
+        double findNs = PerTickNs(workload.ticks, [&](const Tick& tick) {
+            applyById(registry.Find(tick.symbol), tick.price);
+        });
+        double idNs = PerTickNs(workload.ticks, [&](const Tick& tick) {
+            applyById(tick.instrument, tick.price);
+        });
+
+        printf("  %9zu   %12.1f   %12.1f   %12.1f   %9.1f\n", positionCount, scanNs, hashNs, findNs, idNs);
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t ticks = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 20000;
+    size_t symbols = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 500;
+    if (ticks == 0 || symbols == 0) {
+        fprintf(stderr, "ticks and symbols must be positive\n");
+        return 1;
+    }
+
+    printf("%zu ticks over %zu symbols; nanoseconds per tick\n", ticks, symbols);
+    printf("  positions   string scan    string hash    Find + ids     ids only\n");
+    for (size_t positions : { 100, 1000, 5000, 20000 }) {
+        RunCase(positions, symbols, ticks);
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Parse cost of a listings response: a full nlohmann DOM (how quotes used to be read)
+// against QuoteExtractor's SAX pass.
+//
+//     QuoteExtractorBench [response.json ...]
+//
+// With no files, a synthetic 5000-row listings/latest body is used. Heap use is measured
+// by counting every allocation made while parsing.
+#include "BenchUtil.h"
+#include "QuoteExtractor.h"
+#include <nlohmann/json.hpp>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    // Allocation counters, updated by the operator new/delete replacements below
+    size_t g_liveBytes = 0;
+    size_t g_peakBytes = 0;
+    size_t g_allocations = 0;
+
+    // Every block carries its size in front, so delete can subtract it
+    constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+    void* CountedAlloc(size_t size) {
+        void* block = std::malloc(size + HEADER_SIZE);
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        *static_cast<size_t*>(block) = size;
+        g_liveBytes += size;
+        g_peakBytes = std::max(g_peakBytes, g_liveBytes);
+        g_allocations++;
+        return static_cast<char*>(block) + HEADER_SIZE;
+    }
+
+    void CountedFree(void* pointer) {
+        if (!pointer) {
+            return;
+        }
+        void* block = static_cast<char*>(pointer) - HEADER_SIZE;
+        g_liveBytes -= *static_cast<size_t*>(block);
+        std::free(block);
+    }
+
+    struct HeapUse {
+        size_t peakBytes = 0;
+        size_t allocations = 0;
+    };
+
+    // Heap used by one call of fn, above what was live before it
+    template <typename Fn>
+    HeapUse MeasureHeap(Fn&& fn) {
+        size_t baseline = g_liveBytes;
+        g_peakBytes = baseline;
+        g_allocations = 0;
+        fn();
+        return HeapUse{ g_peakBytes - baseline, g_allocations };
+    }
+
+    // The old path: build the whole document, then scan "data" for each symbol
+    size_t ParseWithDom(const std::string& body, const std::vector<std::string>& symbols) {
+        nlohmann::json json = nlohmann::json::parse(body);
+        size_t found = 0;
+        for (const auto& symbol : symbols) {
+            for (const auto& entry : json["data"]) {
+                if (entry.contains("symbol") && entry["symbol"] == symbol) {
+                    found += entry["quote"]["USD"].contains("price") ? 1 : 0;
+                    break;
+                }
+            }
+        }
+        return found;
+    }
+
+    size_t ParseWithExtractor(const std::string& body, const std::vector<std::string>& symbols) {
+        QuoteExtractionResult result;
+        QuoteExtractor::Extract(body, symbols, result);
+        return result.quotes.size();
+    }
+
+    void RunCase(const char* label, const std::string& body, const std::vector<std::string>& symbols) {
+        const int iterations = 20;
+        volatile size_t sink = 0;
+        size_t found = ParseWithExtractor(body, symbols);
+
+        double domMs = Bench::MedianMs(iterations, [&]() { sink += ParseWithDom(body, symbols); });
+        HeapUse domHeap = MeasureHeap([&]() { sink += ParseWithDom(body, symbols); });
+        double saxMs = Bench::MedianMs(iterations, [&]() { sink += ParseWithExtractor(body, symbols); });
+        HeapUse saxHeap = MeasureHeap([&]() { sink += ParseWithExtractor(body, symbols); });
+
+        printf("  %-16s %2zu found | DOM %8.2f ms %9.1f KB peak %7zu allocs | SAX %8.2f ms %7.1f KB peak %4zu allocs\n",
+            label, found, domMs, domHeap.peakBytes / 1024.0, domHeap.allocations,
+            saxMs, saxHeap.peakBytes / 1024.0, saxHeap.allocations);
+    }
+
+    void RunBody(const std::string& name, const std::string& body) {
+        printf("%s (%.1f MB)\n", name.c_str(), body.size() / (1024.0 * 1024.0));
+        RunCase("first row (BTC)", body, { "BTC" });
+        RunCase("last row", body, { "C4999" });
+        RunCase("missing symbol", body, { "NOPE" });
+        RunCase("batch of 10", body, { "BTC", "ETH", "C10", "C50", "C100", "C500", "C1000", "C2000", "C3000", "C4999" });
+    }
+}
+
+void* operator new(size_t size) { return CountedAlloc(size); }
+void* operator new[](size_t size) { return CountedAlloc(size); }
+void operator delete(void* pointer) noexcept { CountedFree(pointer); }
+void operator delete[](void* pointer) noexcept { CountedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { CountedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { CountedFree(pointer); }
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        RunBody("synthetic listings/latest, 5000 rows", Bench::MakeListingsResponse(5000));
+        return 0;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        std::string body = Bench::ReadFile(argv[i]);
+        if (body.empty()) {
+            fprintf(stderr, "Could not read %s\n", argv[i]);
+            return 1;
+        }
+        RunBody(argv[i], body);
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+// Enqueue/dequeue throughput of API requests under producer contention: the old
+// mutex-guarded std::vector queue (push_back, copy out of front(), erase(begin()))
+// against the lock-free MpscQueue with move-only requests.
+//
+//     RequestQueueBench [requests_per_producer]
+//
+// Producers and the single consumer run flat out; the consumer polls (yielding when the
+// queue is empty) rather than waiting on a condition variable, so only the queues
+// themselves are compared. The old queue's erase(begin()) makes it quadratic in the
+// backlog, so keep requests_per_producer modest.
+#include "BenchUtil.h"
+#include "MpscQueue.h"
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+    // Shaped like CryptoAPIClient's request: endpoint, parameters and a callback
+    struct Request {
+        std::string endpoint;
+        std::map<std::string, std::string> params;
+        std::function<void(const std::string&)> callback;
+    };
+
+    Request MakeRequest(size_t index) {
+        Request request;
+        request.endpoint = "/v1/cryptocurrency/quotes/latest";
+        request.params["symbol"] = "SYM" + std::to_string(index % 64);
+        request.params["convert"] = "USD";
+        std::string tag = "request " + std::to_string(index);
+        request.callback = [tag](const std::string&) {};
+        return request;
+    }
+
+    // The queue CryptoAPIClient used before the MPSC queue
+    class VectorQueue {
+    public:
+        void Push(Request request) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_requests.push_back(std::move(request));
+        }
+
+        bool TryPop(Request& request) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_requests.empty()) {
+                return false;
+            }
+            request = m_requests.front();
+            m_requests.erase(m_requests.begin());
+            return true;
+        }
+
+    private:
+        std::vector<Request> m_requests;
+        std::mutex m_mutex;
+    };
+
+    class LockFreeQueue {
+    public:
+        void Push(Request request) { m_requests.Push(std::move(request)); }
+        bool TryPop(Request& request) { return m_requests.TryPop(request); }
+
+    private:
+        MpscQueue<Request> m_requests;
+    };
+
+    // Thousands of requests through the queue per second, from first push to last pop.
+    // Requests are built before the clock starts
+    template <typename Queue>
+    double Run(size_t producers, size_t perProducer) {
+        std::vector<std::vector<Request>> batches(producers);
+        for (size_t p = 0; p < producers; p++) {
+            batches[p].reserve(perProducer);
+            for (size_t i = 0; i < perProducer; i++) {
+                batches[p].push_back(MakeRequest(p * perProducer + i));
+            }
+        }
+
+        Queue queue;
+        std::atomic<bool> start{ false };
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; p++) {
+            threads.emplace_back([&queue, &start, &batch = batches[p]]() {
+                while (!start.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (auto& request : batch) {
+                    queue.Push(std::move(request));
+                }
+            });
+        }
+
+        size_t total = producers * perProducer;
+        size_t popped = 0;
+        Request request;
+
+        Bench::Clock::time_point begin = Bench::Clock::now();
+        start.store(true, std::memory_order_release);
+        while (popped < total) {
+            if (queue.TryPop(request)) {
+                popped++;
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+        double elapsedMs = Bench::ElapsedMs(begin);
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return total / elapsedMs;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t perProducer = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 2000;
+
+    printf("%zu requests per producer, one consumer; thousands of requests per second\n", perProducer);
+    printf("  producers   vector+mutex   MpscQueue\n");
+    for (size_t producers : { 1, 2, 4, 8 }) {
+        double vectorRate = Run<VectorQueue>(producers, perProducer);
+        double mpscRate = Run<LockFreeQueue>(producers, perProducer);
+        printf("  %9zu   %12.1f   %9.1f\n", producers, vectorRate, mpscRate);
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Time to a symbol's first chart at startup: a cold start that fetches every day of the
+// history, against a warm start that reads the settled days back from the bar store
+// and only fetches what is missing.
+//
+//     StartupLoadBench [latency_ms] [symbol]
+//
+// Each run is a new CryptoAPIClient, as after a restart, so its in-memory response cache
+// starts empty. Requests go to a stand-in transport that answers every request with a
+// 5000-row listings body after latency_ms (default 250), roughly a CMC round trip and
+// download. The rate limits are lifted so only the round trips are timed. The bar store
+// lives in a scratch directory that is removed afterwards.
+#include "BenchUtil.h"
+#include "BarStore.h"
+#include "Config.h"
+#include "CryptoAPIClient.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace {
+    class StandInTransport : public IHttpTransport {
+    public:
+        StandInTransport(std::shared_ptr<const std::string> body, int latencyMs)
+            : m_body(std::move(body)), m_latencyMs(latencyMs) {
+        }
+
+        bool Get(const std::string&, const std::map<std::string, std::string>&,
+            HttpResponse& response, std::string&) override {
+            std::this_thread::sleep_for(std::chrono::milliseconds(m_latencyMs));
+            m_requests++;
+
+            response.statusCode = 200;
+            response.headers.clear();
+            response.body = *m_body;
+            return true;
+        }
+
+        int GetRequestCount() const { return m_requests; }
+
+    private:
+        std::shared_ptr<const std::string> m_body;
+        int m_latencyMs;
+        std::atomic<int> m_requests{ 0 };
+    };
+
+    struct LoadResult {
+        double firstBarsMs = -1.0;  // first delivery with any bars
+        double completeMs = 0.0;
+        size_t bars = 0;
+        int requests = 0;
+    };
+
+    LoadResult RunLoad(const std::string& symbol, std::shared_ptr<const std::string> body, int latencyMs) {
+        auto transport = std::make_unique<StandInTransport>(std::move(body), latencyMs);
+        StandInTransport* standIn = transport.get();
+
+        CryptoAPIClient client;
+        client.SetTransport(std::move(transport));
+        client.Initialize("bench");
+
+        LoadResult result;
+        std::mutex mutex;
+        std::condition_variable done;
+        bool complete = false;
+
+        Bench::Clock::time_point start = Bench::Clock::now();
+        client.FetchHistoricalData(symbol, [&](const std::shared_ptr<const BarSeries>& series, bool isComplete) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (result.firstBarsMs < 0.0 && !series->Empty()) {
+                result.firstBarsMs = Bench::ElapsedMs(start);
+            }
+            if (isComplete) {
+                result.completeMs = Bench::ElapsedMs(start);
+                result.bars = series->Size();
+                complete = true;
+                done.notify_one();
+            }
+        }, RequestPriority::Interactive);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&]() { return complete; });
+        lock.unlock();
+
+        client.Shutdown();
+        result.requests = standIn->GetRequestCount();
+        return result;
+    }
+
+    void Report(const char* label, const LoadResult& result) {
+        printf("  %-6s first bars %9.1f ms   complete %9.1f ms   %3zu bars   %2d requests\n",
+            label, result.firstBarsMs, result.completeMs, result.bars, result.requests);
+    }
+}
+
+int main(int argc, char** argv) {
+    int latencyMs = argc > 1 ? std::atoi(argv[1]) : 250;
+    std::string symbol = argc > 2 ? argv[2] : "ETH";
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "StartupLoadBench";
+    std::filesystem::remove_all(directory);
+    Config::API::BAR_STORE_DIRECTORY = directory.string();
+    Config::API::REQUESTS_PER_MINUTE = 1000000;
+    Config::API::CREDITS_PER_MINUTE = 1000000;
+    Config::API::CREDITS_PER_DAY = 1000000;
+
+    auto body = std::make_shared<const std::string>(Bench::MakeListingsResponse(5000));
+
+    printf("%s, %d day window, %d ms per request\n", symbol.c_str(), Config::API::HISTORICAL_DAYS, latencyMs);
+    Report("cold", RunLoad(symbol, body, latencyMs));
+    Report("warm", RunLoad(symbol, body, latencyMs));
+
+    // The store read on its own, as the warm start does before anything is fetched
+    BarStore store(Config::API::BAR_STORE_DIRECTORY);
+    std::vector<BarStore::Bar> bars;
+    double loadMs = Bench::MedianMs(50, [&]() {
+        bars.clear();
+        store.Load(symbol, "1d", 0, bars);
+    });
+    printf("  BarStore::Load of %zu bars: %.3f ms\n", bars.size(), loadMs);
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
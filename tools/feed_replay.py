@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+"""Local stand-in for an exchange price feed, speaking MarketFeed's WebSocket protocol.
+
+Replays ticks from a JSON-lines file ({"symbol": ..., "price": ..., ...} per line), or a
+random walk when no file is given, to every connected client. Point the app at it with
+"feed_url": "ws://127.0.0.1:8765/" in config.json.
+
+    python tools/feed_replay.py --port 8765 --rate 20 [--file ticks.jsonl] [--drop-every 500]
+
+--drop-every N skips a sequence number every N messages, to exercise gap recovery.
+Standard library only.
+"""
+import argparse
+import base64
+import hashlib
+import json
+import random
+import socket
+import struct
+import threading
+import time
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+
+def recv_exact(conn, size):
+    data = b""
+    while len(data) < size:
+        chunk = conn.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError("client closed")
+        data += chunk
+    return data
+
+
+def read_frame(conn):
+    """Return (opcode, payload) of the next frame from a client (client frames are masked)."""
+    first, second = recv_exact(conn, 2)
+    opcode = first & 0x0F
+    length = second & 0x7F
+    if length == 126:
+        length = struct.unpack(">H", recv_exact(conn, 2))[0]
+    elif length == 127:
+        length = struct.unpack(">Q", recv_exact(conn, 8))[0]
+    mask = recv_exact(conn, 4) if second & 0x80 else b"\0\0\0\0"
+    payload = bytearray(recv_exact(conn, length))
+    for i in range(length):
+        payload[i] ^= mask[i % 4]
+    return opcode, bytes(payload)
+
+
+def frame(opcode, payload):
+    header = bytes([0x80 | opcode])
+    if len(payload) < 126:
+        header += bytes([len(payload)])
+    elif len(payload) <= 0xFFFF:
+        header += bytes([126]) + struct.pack(">H", len(payload))
+    else:
+        header += bytes([127]) + struct.pack(">Q", len(payload))
+    return header + payload
+
+
+def handshake(conn):
+    request = b""
+    while b"\r\n\r\n" not in request:
+        chunk = conn.recv(4096)
+        if not chunk:
+            raise ConnectionError("client closed during handshake")
+        request += chunk
+    key = ""
+    for line in request.decode("latin-1").split("\r\n"):
+        if line.lower().startswith("sec-websocket-key:"):
+            key = line.split(":", 1)[1].strip()
+    accept = base64.b64encode(hashlib.sha1((key + WS_GUID).encode()).digest()).decode()
+    conn.sendall(("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                  "Sec-WebSocket-Accept: " + accept + "\r\n\r\n").encode())
+
+
+class Ticks:
+    """Source of ticks: the recorded file on a loop, or a random walk per symbol."""
+
+    def __init__(self, path):
+        self.recorded = []
+        if path:
+            with open(path) as f:
+                self.recorded = [json.loads(line) for line in f if line.strip()]
+        self.position = 0
+        self.prices = {}
+        self.lock = threading.Lock()
+
+    def last(self, symbol):
+        with self.lock:
+            return self.prices.setdefault(symbol, 100.0 + random.random() * 100.0)
+
+    def next(self, symbols):
+        with self.lock:
+            if self.recorded:
+                for _ in range(len(self.recorded)):
+                    tick = dict(self.recorded[self.position])
+                    self.position = (self.position + 1) % len(self.recorded)
+                    if tick.get("symbol") in symbols:
+                        self.prices[tick["symbol"]] = tick["price"]
+                        return tick
+                return None
+            if not symbols:
+                return None
+            symbol = random.choice(sorted(symbols))
+            price = self.prices.setdefault(symbol, 100.0 + random.random() * 100.0)
+            price = max(0.01, price * (1.0 + random.gauss(0.0, 0.001)))
+            self.prices[symbol] = price
+            return {"symbol": symbol, "price": price, "volume_24h": 1.0e6, "percent_change_24h": 0.0}
+
+
+class Client:
+    def __init__(self, conn, args, ticks):
+        self.conn = conn
+        self.args = args
+        self.ticks = ticks
+        self.symbols = set()
+        self.seq = 0
+        self.sent = 0
+        self.send_lock = threading.Lock()
+        self.alive = True
+
+    def send(self, message):
+        self.seq += 1
+        self.sent += 1
+        if self.args.drop_every and self.sent % self.args.drop_every == 0:
+            self.seq += 1  # a lost message
+        message["seq"] = self.seq
+        message.setdefault("timestamp", time.time())
+        self.conn.sendall(frame(0x1, json.dumps(message).encode()))
+
+    def reader(self):
+        try:
+            while self.alive:
+                opcode, payload = read_frame(self.conn)
+                if opcode == 0x8:
+                    break
+                if opcode == 0x9:
+                    with self.send_lock:
+                        self.conn.sendall(frame(0xA, payload))
+                    continue
+                request = json.loads(payload)
+                if request.get("op") == "subscribe":
+                    with self.send_lock:
+                        self.symbols = set(request.get("symbols", []))
+                        # Snapshot of every subscribed symbol
+                        for symbol in sorted(self.symbols):
+                            self.send({"type": "tick", "symbol": symbol, "price": self.ticks.last(symbol)})
+        except (ConnectionError, OSError, ValueError):
+            pass
+        self.alive = False
+
+    def run(self):
+        threading.Thread(target=self.reader, daemon=True).start()
+        interval = 1.0 / self.args.rate
+        next_heartbeat = time.time() + self.args.heartbeat
+        try:
+            while self.alive:
+                time.sleep(interval)
+                with self.send_lock:
+                    tick = self.ticks.next(self.symbols)
+                    if tick:
+                        tick["type"] = "tick"
+                        tick.pop("seq", None)
+                        self.send(tick)
+                    if time.time() >= next_heartbeat:
+                        self.send({"type": "heartbeat"})
+                        next_heartbeat = time.time() + self.args.heartbeat
+        except OSError:
+            pass
+        self.alive = False
+        self.conn.close()
+
+
+def serve(conn, args, ticks):
+    try:
+        handshake(conn)
+    except (ConnectionError, OSError):
+        conn.close()
+        return
+    Client(conn, args, ticks).run()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", type=int, default=8765)
+    parser.add_argument("--file", help="JSON-lines ticks to replay (random walk if omitted)")
+    parser.add_argument("--rate", type=float, default=20.0, help="ticks per second per client")
+    parser.add_argument("--heartbeat", type=float, default=1.0, help="seconds between heartbeats")
+    parser.add_argument("--drop-every", type=int, default=0, help="skip a sequence number every N messages")
+    args = parser.parse_args()
+
+    ticks = Ticks(args.file)
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(("127.0.0.1", args.port))
+    server.listen()
+    print("Replaying feed on ws://127.0.0.1:%d/" % args.port)
+    while True:
+        conn, _ = server.accept()
+        conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        threading.Thread(target=serve, args=(conn, args, ticks), daemon=True).start()
+
+
+if __name__ == "__main__":
+    main()